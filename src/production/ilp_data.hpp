@@ -5,8 +5,13 @@
 #include "utility.hpp"
 
 #include <algorithm>
+#include <cassert>
 #include <limits>
+#include <memory_resource>
 #include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace ilp_solver
@@ -15,6 +20,7 @@ namespace ilp_solver
 struct ILPDataBase
 {
     ObjectiveSense objective_sense{ObjectiveSense::MINIMIZE};
+    SolverBackend  backend{SolverBackend::DEFAULT};
 
     // Defaults will be overwritten in ilp_solver_collect,
     // but are initialized to the same constants to be sure.
@@ -29,34 +35,70 @@ struct ILPDataBase
     double max_rel_gap   { c_default_max_rel_gap   };
     double cutoff        { c_default_cutoff        };
 
+    InterimPolicy interim_policy{};
+
     virtual ~ILPDataBase() = default;
 };
 
 
 struct ILPData final : public ILPDataBase
 {
-    // Internally, a vector of rows/constraints is stored. The size of the outer vector is the number of constraints.
-    // The inner vectors store only non-zero entries (sparse matrix).
+    // The constraint matrix is stored in compressed sparse row (CSR) format in three contiguous arrays:
+    // The non-zero entries of row i are d_values[k] in column d_indices[k] for d_row_starts[i] <= k < d_row_starts[i + 1].
+    // d_row_starts always has one entry more than there are rows and starts with 0.
     // Number of variables = number of columns = d_num_cols.
     // If no constraints are given, we can not know the number of variables. (m x 0 can be stored, 0 x n can not).
-    // Appending a row is faster than appending a column.
+    // Non-zeros of appended columns are only recorded as (row, column, value) triplets and merged into the rows by flush(),
+    // so that appending a column costs the same as appending a row. Call flush() before reading the CSR arrays.
     struct Matrix
     {
+        struct Triplet
+        {
+            int    row;
+            int    col;
+            double value;
+        };
+
+        Matrix() = default;
+        explicit Matrix(std::pmr::memory_resource* p_resource)
+            : d_row_starts(1, 0, p_resource), d_indices(p_resource), d_values(p_resource) {}
+
+        int num_rows()      const { return isize(d_row_starts) - 1; }
+        int num_non_zeros() const { return isize(d_values) + isize(d_column_entries); }
+
+        IndexArray row_indices(int p_row) const
+        {
+            assert(d_column_entries.empty());
+            return IndexArray(d_indices).subspan(d_row_starts[p_row], d_row_starts[p_row + 1] - d_row_starts[p_row]);
+        }
+
+        ValueArray row_values(int p_row) const
+        {
+            assert(d_column_entries.empty());
+            return ValueArray(d_values).subspan(d_row_starts[p_row], d_row_starts[p_row + 1] - d_row_starts[p_row]);
+        }
+
+
+        void reserve(int p_num_rows, int p_num_non_zeros)
+        {
+            d_row_starts.reserve(d_row_starts.size() + p_num_rows);
+            d_indices.reserve(d_indices.size() + p_num_non_zeros);
+            d_values.reserve(d_values.size() + p_num_non_zeros);
+        }
+
+
         void append_column(ValueArray p_row_values)
         {
-            assert(p_row_values.size() == d_values.size());
+            assert(isize(p_row_values) == num_rows());
 
-            if (d_values.empty())
+            if (num_rows() == 0)
                 return;
 
-            // Set specified values.
-            for (int i = 0; i < isize(d_values); ++i)
+            // Record specified values.
+            for (int i = 0; i < isize(p_row_values); ++i)
             {
                 if (p_row_values[i] != 0.)
-                {
-                    d_values[i].push_back(p_row_values[i]);
-                    d_indices[i].push_back(d_num_cols);
-                }
+                    d_column_entries.push_back({i, d_num_cols, p_row_values[i]});
             }
             ++d_num_cols;
         }
@@ -66,54 +108,26 @@ struct ILPData final : public ILPDataBase
         {
             assert(p_row_indices.size() == p_row_values.size());
 
-            if (d_values.empty())
-                return;
-
-            // Set specified values.
-            for (auto i = 0; i < isize(p_row_indices); ++i)
-            {
-                const auto row_index = p_row_indices[i];
-                const auto value     = p_row_values[i];
-                assert(0 <= row_index && row_index < isize(d_values));
-
-                if (value != 0.)
-                {
-                    d_values[row_index].push_back(value);
-                    d_indices[row_index].push_back(d_num_cols);
-                }
-            }
-            ++d_num_cols;
+            const int col_starts[] = {0, isize(p_row_indices)};
+            append_columns(1, col_starts, p_row_indices, p_row_values);
         }
 
 
         void append_row(ValueArray p_col_values)
         {
-            // Count non-zero values.
-            int num_non_zero_values = 0;
-            for (auto value : p_col_values)
-                num_non_zero_values += (value != 0);
-
-            // Add new row.
-            auto& values = d_values.emplace_back();
-            auto& indices = d_indices.emplace_back();
-
-            if (num_non_zero_values == 0)
-                return;
-
-            values.reserve(num_non_zero_values);
-            indices.reserve(num_non_zero_values);
-
             // Set specified values.
             for (int i = 0; i < isize(p_col_values); ++i)
             {
                 if (p_col_values[i] != 0.)
                 {
-                    values.push_back(p_col_values[i]);
-                    indices.push_back(i);
+                    d_values.push_back(p_col_values[i]);
+                    d_indices.push_back(i);
                 }
             }
+            d_row_starts.push_back(isize(d_values));
 
-            d_num_cols = std::max(d_num_cols, isize(p_col_values));
+            if (d_row_starts[num_rows()] != d_row_starts[num_rows() - 1])
+                d_num_cols = std::max(d_num_cols, isize(p_col_values));
         }
 
 
@@ -121,38 +135,131 @@ struct ILPData final : public ILPDataBase
         {
             assert(p_col_indices.size() == p_col_values.size());
 
-            // Add new row.
-            auto& values  = d_values.emplace_back();
-            auto& indices = d_indices.emplace_back();
-            values.reserve(p_col_indices.size());
-            indices.reserve(p_col_indices.size());
-
             // Set specified values.
             for (int i = 0; i < isize(p_col_values); ++i)
             {
                 if (p_col_values[i] != 0.)
                 {
-                    values.push_back(p_col_values[i]);
-                    indices.push_back(p_col_indices[i]);
+                    d_values.push_back(p_col_values[i]);
+                    d_indices.push_back(p_col_indices[i]);
                     d_num_cols = std::max(d_num_cols, p_col_indices[i] + 1);
                 }
             }
+            d_row_starts.push_back(isize(d_values));
+        }
+
+
+        // Bulk version of append_column. p_col_starts is empty or has p_num_columns + 1 entries (CSC format).
+        void append_columns(int p_num_columns, IndexArray p_col_starts, IndexArray p_row_indices, ValueArray p_row_values)
+        {
+            if (num_rows() == 0)
+                return;
+
+            // Record specified values.
+            for (int j = 0; !p_col_starts.empty() && j < p_num_columns; ++j)
+            {
+                for (int k = p_col_starts[j]; k < p_col_starts[j + 1]; ++k)
+                {
+                    assert(0 <= p_row_indices[k] && p_row_indices[k] < num_rows());
+                    if (p_row_values[k] != 0.)
+                        d_column_entries.push_back({p_row_indices[k], d_num_cols + j, p_row_values[k]});
+                }
+            }
+            d_num_cols += p_num_columns;
         }
 
-        std::vector<std::vector<double>> d_values;  // For each row: non-zero values.
-        std::vector<std::vector<int>>    d_indices; // For each row: column indices of the non-zero values.
-        int                              d_num_cols{0};
 
+        // Bulk version of append_row. p_row_starts has one entry more than there are new rows (CSR format).
+        void append_rows(IndexArray p_row_starts, IndexArray p_col_indices, ValueArray p_col_values)
+        {
+            const auto num_new_rows = isize(p_row_starts) - 1;
+            reserve(num_new_rows, p_row_starts.back() - p_row_starts.front());
+            for (int i = 0; i < num_new_rows; ++i)
+            {
+                const auto begin = p_row_starts[i];
+                const auto size  = p_row_starts[i + 1] - begin;
+                append_row(p_col_indices.subspan(begin, size), p_col_values.subspan(begin, size));
+            }
+        }
+
+
+        // Merges the recorded column entries into the CSR arrays.
+        // The triplets are sorted by row with one counting sort pass. Within a row, they keep their column order
+        // and all have larger column indices than the entries already stored, so they are appended to the row.
+        // Then all rows are moved backwards to their new positions in a single pass.
+        void flush()
+        {
+            if (d_column_entries.empty())
+                return;
+
+            std::vector<int> new_starts(num_rows() + 1, 0);
+            for (const auto& entry : d_column_entries)
+                ++new_starts[entry.row + 1];
+            for (int i = 0; i < num_rows(); ++i)
+                new_starts[i + 1] += new_starts[i];
+
+            const auto       num_new = isize(d_column_entries);
+            std::vector<int> next(new_starts.begin(), new_starts.end() - 1);
+            std::vector<int> new_indices(num_new);
+            std::vector<double> new_values(num_new);
+            for (const auto& entry : d_column_entries)
+            {
+                const auto pos   = next[entry.row]++;
+                new_indices[pos] = entry.col;
+                new_values[pos]  = entry.value;
+            }
+            d_column_entries = {};
+
+            d_indices.resize(d_indices.size() + num_new);
+            d_values.resize(d_values.size() + num_new);
+            for (int i = num_rows() - 1; i >= 0 && new_starts[i + 1] > 0; --i)
+            {
+                const auto old_begin = d_row_starts[i];
+                const auto old_end   = d_row_starts[i + 1];
+                const auto num_added = new_starts[i + 1] - new_starts[i];
+                const auto new_end   = old_end + new_starts[i + 1];
+                std::move_backward(d_indices.begin() + old_begin, d_indices.begin() + old_end, d_indices.begin() + new_end - num_added);
+                std::move_backward(d_values.begin()  + old_begin, d_values.begin()  + old_end, d_values.begin()  + new_end - num_added);
+                std::copy_n(new_indices.begin() + new_starts[i], num_added, d_indices.begin() + new_end - num_added);
+                std::copy_n(new_values.begin()  + new_starts[i], num_added, d_values.begin()  + new_end - num_added);
+                d_row_starts[i + 1] = new_end;
+            }
+        }
+
+        std::pmr::vector<int>    d_row_starts{0};  // For each row: position of its first non-zero. Plus the total number of non-zeros.
+        std::pmr::vector<int>    d_indices;        // Column indices of the non-zero values.
+        std::pmr::vector<double> d_values;         // Non-zero values.
+        std::vector<Triplet>     d_column_entries; // Non-zeros of appended columns that are not yet merged into the rows.
+        int                      d_num_cols{0};
     };
 
-    Matrix                    matrix;
-    std::vector<double>       objective;
-    std::vector<double>       variable_lower;
-    std::vector<double>       variable_upper;
-    std::vector<double>       constraint_lower;
-    std::vector<double>       constraint_upper;
-    std::vector<VariableType> variable_type;
-    std::vector<double>       start_solution;
+    // The arrays are allocated from the default memory resource (the heap), unless another one is given.
+    // ILPSolverStub allocates them in shared memory (see SharedMemoryArena), such that they need not be copied for the solver process.
+    ILPData() = default;
+    explicit ILPData(std::pmr::memory_resource* p_resource)
+        : matrix(p_resource), objective(p_resource), variable_lower(p_resource), variable_upper(p_resource),
+          constraint_lower(p_resource), constraint_upper(p_resource), variable_type(p_resource), start_solution(p_resource),
+          solver_parameters(p_resource) {}
+
+    // Appends a parameter for ILPSolverInterface::set_solver_parameter to solver_parameters.
+    void add_solver_parameter(const std::string& p_name, const std::string& p_value)
+    {
+        assert(!p_name.empty() && p_name.find_first_of("=\n") == std::string::npos && p_value.find('\n') == std::string::npos);
+        solver_parameters.insert(solver_parameters.end(), p_name.begin(), p_name.end());
+        solver_parameters.push_back('=');
+        solver_parameters.insert(solver_parameters.end(), p_value.begin(), p_value.end());
+        solver_parameters.push_back('\n');
+    }
+
+    Matrix                         matrix;
+    std::pmr::vector<double>       objective;
+    std::pmr::vector<double>       variable_lower;
+    std::pmr::vector<double>       variable_upper;
+    std::pmr::vector<double>       constraint_lower;
+    std::pmr::vector<double>       constraint_upper;
+    std::pmr::vector<VariableType> variable_type;
+    std::pmr::vector<double>       start_solution;
+    std::pmr::vector<char>         solver_parameters; // One "name=value" line per parameter, in the order they were set.
 };
 
 
@@ -161,9 +268,18 @@ struct ILPDataView final : public ILPDataBase
 {
     struct Matrix
     {
-        std::vector<std::span<double>> d_values;
-        std::vector<std::span<int>>    d_indices;
-        int                            d_num_cols{0};
+        int num_rows() const { return isize(d_row_starts) - 1; }
+
+        IndexArray row_indices(int p_row) const
+        { return IndexArray(d_indices).subspan(d_row_starts[p_row], d_row_starts[p_row + 1] - d_row_starts[p_row]); }
+
+        ValueArray row_values(int p_row) const
+        { return ValueArray(d_values).subspan(d_row_starts[p_row], d_row_starts[p_row + 1] - d_row_starts[p_row]); }
+
+        std::span<int>    d_row_starts;
+        std::span<int>    d_indices;
+        std::span<double> d_values;
+        int               d_num_cols{0};
     };
 
     Matrix                  matrix;
@@ -174,9 +290,50 @@ struct ILPDataView final : public ILPDataBase
     std::span<double>       constraint_upper;
     std::span<VariableType> variable_type;
     std::span<double>       start_solution;
+    std::span<char>         solver_parameters;
 };
 
 
+// Views the arrays of p_data, e.g. to pass them to ILPSolverInterface::load_model. Call p_data.matrix.flush() before.
+inline ILPDataView make_view(ILPData& p_data)
+{
+    assert(p_data.matrix.d_column_entries.empty());
+
+    ILPDataView view;
+    static_cast<ILPDataBase&>(view) = p_data;
+    view.matrix.d_row_starts = p_data.matrix.d_row_starts;
+    view.matrix.d_indices    = p_data.matrix.d_indices;
+    view.matrix.d_values     = p_data.matrix.d_values;
+    view.matrix.d_num_cols   = p_data.matrix.d_num_cols;
+    view.objective           = p_data.objective;
+    view.variable_lower      = p_data.variable_lower;
+    view.variable_upper      = p_data.variable_upper;
+    view.constraint_lower    = p_data.constraint_lower;
+    view.constraint_upper    = p_data.constraint_upper;
+    view.variable_type       = p_data.variable_type;
+    view.start_solution      = p_data.start_solution;
+    view.solver_parameters   = p_data.solver_parameters;
+    return view;
+}
+
+
+// Calls p_function(name, value) for each line of ILPData::solver_parameters in p_text.
+template<typename Function>
+void for_each_solver_parameter(std::span<const char> p_text, Function p_function)
+{
+    while (!p_text.empty())
+    {
+        const auto line_end = std::ranges::find(p_text, '\n');
+        const auto line     = std::string_view(p_text.data(), static_cast<std::size_t>(line_end - p_text.begin()));
+        const auto equals   = line.find('=');
+        if (equals == std::string_view::npos)
+            throw std::runtime_error("Invalid solver parameter \"" + std::string(line) + "\".");
+        p_function(std::string(line.substr(0, equals)), std::string(line.substr(equals + 1)));
+        p_text = p_text.subspan(line.size() + (line_end == p_text.end() ? 0 : 1));
+    }
+}
+
+
 struct ILPSolutionData
 {
     std::vector<double> solution;
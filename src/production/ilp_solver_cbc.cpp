@@ -19,38 +19,50 @@
 
 namespace ilp_solver
 {
+    // Offers improving solutions to the interim delivery, reports progress and stops the search when a stop is requested.
+    // CBC asks for an action at each node, so that is where progress is reported and the stop condition is checked.
     class InterimEventHandler : public CbcEventHandler
     {
     public:
         CbcAction event(CbcEvent whichevent) override;
         CbcEventHandler* clone() const override;
 
-        InterimEventHandler(std::function<void (ILPSolutionData*)> p_interim_handler) : d_interim_handler{std::move(p_interim_handler)} {}
+        // p_check_stop reports the progress and returns whether to stop.
+        // v_interim and v_mutex belong to the solver, such that the clones of CBC share them.
+        // With several threads, CBC calls the clones concurrently, so each event locks v_mutex.
+        InterimEventHandler(InterimDelivery* v_interim, std::mutex* v_mutex, std::function<bool (const SolverProgress&)> p_check_stop)
+            : d_interim{v_interim}, d_mutex{v_mutex}, d_check_stop{std::move(p_check_stop)} {}
     private:
-         std::function<void (ILPSolutionData*)> d_interim_handler;
-         ILPSolutionData                        d_last_solution;
+         InterimDelivery*                            d_interim;
+         std::mutex*                                 d_mutex;
+         std::function<bool (const SolverProgress&)> d_check_stop;
     };
 
 
     CbcEventHandler::CbcAction InterimEventHandler::event(CbcEvent p_whichevent)
     {
-        if (p_whichevent == CbcEvent::solution || p_whichevent == CbcEvent::heuristicSolution)
+        const std::lock_guard lock(*d_mutex);
+        if (p_whichevent == CbcEvent::node || p_whichevent == CbcEvent::treeStatus)
         {
-            auto          model         = this->getModel();
+            d_interim->poll();
+            const auto model = this->getModel();
+            if (d_check_stop({model->getNodeCount(), model->getBestPossibleObjValue()}))
+                return CbcAction::stop;
+        }
+
+        if (d_interim->has_handler() && (p_whichevent == CbcEvent::solution || p_whichevent == CbcEvent::heuristicSolution))
+        {
+            const auto    model         = this->getModel();
             const double* best_solution = model->bestSolution();
             if (!best_solution)
                 return CbcAction::noAction;
 
-            auto new_value = model->getObjValue();
-            if (d_last_solution.solution_status == SolutionStatus::NO_SOLUTION
-                || (model->getObjSense() * d_last_solution.objective > model->getObjSense() * new_value))
-            {
-                auto size = model->getNumCols();
-                d_last_solution.solution.assign(best_solution, best_solution + size);
-                d_last_solution.objective = new_value;
-                d_last_solution.solution_status = SolutionStatus::SUBOPTIMAL;
-                d_interim_handler(&d_last_solution);
-            }
+            // Only copied if the policy of the delivery takes the solution.
+            d_interim->offer(model->getObjValue(), [model, best_solution](double* r_values)
+                             {
+                                 std::copy_n(best_solution, model->getNumCols(), r_values);
+                                 return true;
+                             });
         }
         return CbcAction::noAction;
     }
@@ -73,6 +85,7 @@ namespace ilp_solver
 
         d_model.assignSolver(solver, true);
         set_default_parameters(this);
+        pass_in_event_handler();
     }
 
 
@@ -207,7 +220,17 @@ namespace ilp_solver
 
     void ILPSolverCbc::set_interim_results(std::function<void (ILPSolutionData*)> p_interim_handler)
     {
-        InterimEventHandler handler{ p_interim_handler };
+        d_interim.set_handler(std::move(p_interim_handler));
+    }
+
+
+    void ILPSolverCbc::pass_in_event_handler()
+    {
+        InterimEventHandler handler{ &d_interim, &d_event_mutex, [this](const SolverProgress& p_progress)
+                                                                 {
+                                                                     report_progress(p_progress);
+                                                                     return stop_requested();
+                                                                 } };
         d_model.passInEventHandler(&handler); // CBC clones the handler, so no dangling pointer.
     }
 
@@ -226,8 +249,11 @@ namespace ilp_solver
         if (probing_ptr)
             delete probing_ptr;
 
+        d_interim.start(d_interim_policy, d_model.getObjSense() < 0 ? ObjectiveSense::MAXIMIZE : ObjectiveSense::MINIMIZE,
+                        d_model.getNumCols());
         d_model.initialSolve();
         d_model.branchAndBound();
+        d_interim.finish();
     }
 
 
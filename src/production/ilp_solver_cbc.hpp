@@ -9,10 +9,13 @@ static_assert(false,
 #endif
 
 #include "ilp_solver_osi_model.hpp" // Including this also links with the required COIN Libraries.
+#include "interim_delivery.hpp"
 
 #include <CbcModel.hpp>
 #include <OsiClpSolverInterface.hpp>
 
+#include <mutex>
+
 class OsiSolverInterface;
 
 
@@ -53,6 +56,12 @@ namespace ilp_solver
         private:
             CbcModel d_model;
 
+            InterimDelivery d_interim;
+            std::mutex      d_event_mutex; // Serializes the event handlers of the threads of CBC, which share d_interim.
+
+            // Installs the event handler for d_interim, the progress handler and the stop condition.
+            void pass_in_event_handler();
+
             OsiSolverInterface*       get_solver_osi_model    ()       override;
 
             void solve_impl() override;
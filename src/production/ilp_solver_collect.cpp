@@ -1,13 +1,16 @@
 #include "ilp_solver_collect.hpp"
 
+#include "model_evaluator.hpp"
 #include "utility.hpp"
 
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 #include <cassert>
-#include <format>
-#include <span>
-#include <sstream>
+#include <charconv>
+#include <ostream>
+#include <string>
+#include <string_view>
 #include <vector>
 
 
@@ -28,124 +31,147 @@ int ILPSolverCollect::get_num_variables() const
 
 namespace
 {
-    // Return string prefixed with p_type, followed by p_num left aligned and padded to 10 chars with spaces.
-    std::string to_name(int p_num, char p_type)
+    constexpr auto c_mps_buffer_size = 1 << 20;
+
+    // Collects the MPS file in a large buffer, which is written to the stream whenever it is full.
+    // Numbers are formatted with std::to_chars, i.e., locale-independent and in shortest round-trip precision.
+    class MpsWriter
     {
-        return std::format("{}{:<10}", p_type, p_num);
-    }
+    public:
+        explicit MpsWriter(std::ostream& p_outstream) : d_outstream(p_outstream)
+        {
+            d_buffer.reserve(c_mps_buffer_size + 256);
+        }
+
+        MpsWriter& operator<<(std::string_view p_text)
+        {
+            d_buffer.append(p_text);
+            return flush_if_full();
+        }
+
+        MpsWriter& operator<<(char p_char)
+        {
+            d_buffer.push_back(p_char);
+            return flush_if_full();
+        }
+
+        MpsWriter& operator<<(double p_value)
+        {
+            char buffer[32];
+            const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), p_value);
+            assert(error == std::errc());
+            d_buffer.append(buffer, end);
+            return flush_if_full();
+        }
+
+        // Writes p_type, followed by p_num left aligned and padded to 10 chars with spaces.
+        MpsWriter& name(char p_type, int p_num)
+        {
+            char buffer[16];
+            const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), p_num);
+            assert(error == std::errc());
+            d_buffer.push_back(p_type);
+            d_buffer.append(buffer, end);
+            d_buffer.append(std::max(10 - static_cast<int>(end - buffer), 0), ' ');
+            return flush_if_full();
+        }
+
+        void flush()
+        {
+            d_outstream.write(d_buffer.data(), std::ssize(d_buffer));
+            d_buffer.clear();
+        }
+
+    private:
+        MpsWriter& flush_if_full()
+        {
+            if (d_buffer.size() >= c_mps_buffer_size)
+                flush();
+            return *this;
+        }
+
+        std::ostream& d_outstream;
+        std::string   d_buffer;
+    };
 
 
-    std::vector<std::string> handle_mps_rows(const ILPData& p_data)
+    // A row is called p_prefix followed by its number among all rows with the same prefix.
+    // Ranges are written as 'E' rows, and free rows are not written at all.
+    struct MpsRow
     {
-        std::vector<std::string> cons_names;
-        cons_names.reserve(p_data.constraint_lower.size() + 2);
+        char type;   // 'E', 'G', 'L', or 0 for free rows.
+        char prefix; // 'E', 'R', 'G' or 'L'.
+        int  number;
+    };
+
+
+    std::vector<MpsRow> mps_rows(const ILPData& p_data)
+    {
+        std::vector<MpsRow> rows;
+        rows.reserve(p_data.constraint_lower.size());
 
         int eq_cons{0};
         int leq_cons{0};
         int geq_cons{0};
         int range_cons{0};
 
-        std::stringstream cons, rhs, rhs_range;
-
         for (int i = 0; i < isize(p_data.constraint_lower); ++i)
         {
             const auto lower = p_data.constraint_lower[i];
             const auto upper = p_data.constraint_upper[i];
             if (lower == upper)
-            {
-                cons_names.emplace_back(to_name(eq_cons++, 'E'));
-                cons << " E  " << cons_names.back() << '\n';
-                rhs << "    RHS             " << cons_names.back() << ' ' << lower << '\n';
-            }
+                rows.push_back({'E', 'E', eq_cons++});
+            else if (lower >= c_neg_inf_bound && upper <= c_pos_inf_bound)
+                rows.push_back({'E', 'R', range_cons++});
+            else if (lower >= c_neg_inf_bound)
+                rows.push_back({'G', 'G', geq_cons++});
+            else if (upper <= c_pos_inf_bound)
+                rows.push_back({'L', 'L', leq_cons++});
             else
-            {
-                if (lower >= c_neg_inf_bound)
-                {
-                    if (upper <= c_pos_inf_bound)
-                    {
-                        cons_names.emplace_back(to_name(range_cons++, 'R'));
-                        cons << " E  " << cons_names.back() << '\n'; // Ranges are handled differently.
-                        rhs << "    RHS             " << cons_names.back() << ' ' << lower << '\n';
-                        rhs_range << "    RHS             " << cons_names.back() << ' ' << upper - lower << '\n';
-                    }
-                    else
-                    {
-                        cons_names.emplace_back(to_name(geq_cons++, 'G'));
-                        cons << " G  " << cons_names.back() << '\n';
-                        rhs << "    RHS             " << cons_names.back() << ' ' << lower << '\n';
-                    }
-                }
-                else
-                {
-                    if (upper <= c_pos_inf_bound)
-                    {
-                        cons_names.emplace_back(to_name(leq_cons++, 'L'));
-                        cons << " L  " << cons_names.back() << '\n';
-                        rhs << "    RHS             " << cons_names.back() << ' ' << upper << '\n';
-                    }
-                    else
-                    {
-                        cons_names.emplace_back("");
-                    }
-                }
-            }
+                rows.push_back({0, 0, 0});
         }
-        cons_names.emplace_back("ROWS\n N  OBJ\n" + std::move(cons).str());
-        cons_names.emplace_back("RHS\n" + std::move(rhs).str());
-        auto ranges = std::move(rhs_range).str();
-        if (!ranges.empty())
-            cons_names.back().append("RANGES\n" + ranges);
-
-        return cons_names;
+        return rows;
     }
 
-    std::string handle_mps_cols(const ILPData& p_data, std::span<std::string> p_names, boost::filesystem::ofstream& v_outstream)
+
+    // Column-major copy of the constraint matrix.
+    struct MpsColumns
     {
-        std::stringstream bounds;
+        std::vector<int>    col_starts;
+        std::vector<int>    row_indices;
+        std::vector<double> values;
+    };
 
-        v_outstream << "COLUMNS\n";
-        for (int i = 0; i < isize(p_data.objective); ++i)
+
+    MpsColumns transpose(const ILPData::Matrix& p_matrix, int p_num_cols)
+    {
+        MpsColumns columns;
+        columns.col_starts.assign(p_num_cols + 1, 0);
+        columns.row_indices.resize(p_matrix.d_indices.size());
+        columns.values.resize(p_matrix.d_values.size());
+
+        for (auto col : p_matrix.d_indices)
+            ++columns.col_starts[col + 1];
+        for (int j = 0; j < p_num_cols; ++j)
+            columns.col_starts[j + 1] += columns.col_starts[j];
+
+        std::vector<int> next(columns.col_starts.begin(), columns.col_starts.end() - 1);
+        for (int i = 0; i < p_matrix.num_rows(); ++i)
         {
-            const auto name = to_name(i, 'X');
-            const auto obj  = p_data.objective[i];
-            const auto ub   = p_data.variable_upper[i];
-            const auto lb   = p_data.variable_lower[i];
-            const auto type = p_data.variable_type[i];
-
-            std::string bound1;
-            std::string bound2;
-
-            if (type == VariableType::BINARY)
-                bounds << " BV BOUND           " << name << " \n";
-            else if (type == VariableType::INTEGER)
+            for (int k = p_matrix.d_row_starts[i]; k < p_matrix.d_row_starts[i + 1]; ++k)
             {
-                bounds << " UI BOUND           " << name << ' ' << ub << '\n';
-                bounds << " LI BOUND           " << name << ' ' << lb << '\n';
-            }
-            else
-            {
-                bounds << " UP BOUND           " << name << ' ' << ub << '\n';
-                bounds << " LO BOUND           " << name << ' ' << lb << '\n';
+                const auto pos           = next[p_matrix.d_indices[k]]++;
+                columns.row_indices[pos] = i;
+                columns.values[pos]      = p_matrix.d_values[k];
             }
+        }
+        return columns;
+    }
 
-            v_outstream << "    " << name << ' ' << "OBJ             " << obj << '\n';
 
-            for (int j = 0; j < isize(p_data.matrix.d_indices); ++j)
-            {
-                double value = 0.;
-                for (int k = 0; k < isize(p_data.matrix.d_indices[j]); ++k)
-                {
-                    if (p_data.matrix.d_indices[j][k] == i)
-                    {
-                        value = p_data.matrix.d_values[j][k];
-                        break;
-                    }
-                }
-
-                v_outstream << "    " << name << ' ' << p_names[j] << ' ' << value << '\n';
-            }
-        }
-        return "BOUNDS\n" + std::move(bounds).str();
+    MpsWriter& operator<<(MpsWriter& v_writer, const MpsRow& p_row)
+    {
+        return v_writer.name(p_row.prefix, p_row.number);
     }
 } // namespace
 
@@ -154,30 +180,102 @@ void ILPSolverCollect::print_mps_file(const std::string& p_filename)
     boost::filesystem::ofstream outstream{boost::filesystem::path(p_filename)};
     assert(outstream);
     assert(d_ilp_data.constraint_lower.size() == d_ilp_data.constraint_upper.size());
+    d_ilp_data.matrix.flush();
 
-    auto names = handle_mps_rows(d_ilp_data);
+    const auto rows    = mps_rows(d_ilp_data);
+    const auto columns = transpose(d_ilp_data.matrix, get_num_variables());
 
-    outstream << "NAME\n";
-    // Print Rows.
-    outstream << names[names.size() - 2];
+    MpsWriter writer(outstream);
+    writer << "NAME\n";
 
-    // Prints columns;
-    auto bounds = handle_mps_cols(d_ilp_data, names, outstream);
+    // Print rows.
+    writer << "ROWS\n N  OBJ\n";
+    for (const auto& row : rows)
+    {
+        if (row.type != 0)
+            writer << ' ' << row.type << "  " << row << '\n';
+    }
 
-    // Prints RHS and RANGE
-    outstream << names.back();
+    // Print columns. Only non-zeros are written.
+    writer << "COLUMNS\n";
+    for (int j = 0; j < get_num_variables(); ++j)
+    {
+        writer << "    ";
+        writer.name('X', j) << " OBJ             " << d_ilp_data.objective[j] << '\n';
 
-    // Prints Bounds
-    outstream << bounds;
+        for (int k = columns.col_starts[j]; k < columns.col_starts[j + 1]; ++k)
+        {
+            const auto& row = rows[columns.row_indices[k]];
+            if (row.type == 0)
+                continue;
+            writer << "    ";
+            writer.name('X', j) << ' ' << row << ' ' << columns.values[k] << '\n';
+        }
+    }
+
+    // Print right hand sides and ranges.
+    writer << "RHS\n";
+    for (int i = 0; i < isize(rows); ++i)
+    {
+        const auto& row = rows[i];
+        if (row.type != 0)
+            writer << "    RHS             " << row << ' '
+                   << (row.type == 'L' ? d_ilp_data.constraint_upper[i] : d_ilp_data.constraint_lower[i]) << '\n';
+    }
+    if (std::ranges::any_of(rows, [](const auto& p_row) { return p_row.prefix == 'R'; }))
+    {
+        writer << "RANGES\n";
+        for (int i = 0; i < isize(rows); ++i)
+        {
+            if (rows[i].prefix == 'R')
+                writer << "    RHS             " << rows[i] << ' '
+                       << d_ilp_data.constraint_upper[i] - d_ilp_data.constraint_lower[i] << '\n';
+        }
+    }
+
+    // Print bounds.
+    writer << "BOUNDS\n";
+    for (int j = 0; j < get_num_variables(); ++j)
+    {
+        const auto type = d_ilp_data.variable_type[j];
+        const auto ub   = d_ilp_data.variable_upper[j];
+        const auto lb   = d_ilp_data.variable_lower[j];
+
+        if (type == VariableType::BINARY)
+        {
+            writer << " BV BOUND           ";
+            writer.name('X', j) << " \n";
+        }
+        else
+        {
+            const auto integer = type == VariableType::INTEGER;
+            writer << (integer ? " UI BOUND           " : " UP BOUND           ");
+            writer.name('X', j) << ' ' << ub << '\n';
+            writer << (integer ? " LI BOUND           " : " LO BOUND           ");
+            writer.name('X', j) << ' ' << lb << '\n';
+        }
+    }
 
     // Finished.
-    outstream << "ENDATA\n";
+    writer << "ENDATA\n";
+    writer.flush();
 }
 
 
+// The solvers that get d_ilp_data enforce the time limit themselves.
+// The stub gives its process some more time (see WatchdogPolicy), which includes starting the process.
 ILPSolverCollect::ILPSolverCollect()
 {
     set_default_parameters(this);
+    d_enforce_max_seconds = false;
+}
+
+
+ILPSolverCollect::ILPSolverCollect(std::unique_ptr<std::pmr::memory_resource> p_memory_resource)
+    : d_memory_resource(std::move(p_memory_resource)), d_ilp_data(d_memory_resource.get())
+{
+    set_default_parameters(this);
+    d_enforce_max_seconds = false;
 }
 
 
@@ -189,13 +287,13 @@ void ILPSolverCollect::add_variable_impl(VariableType p_type, double p_objective
     {
         if (!p_row_indices)
         {
-            assert(p_row_values->size() == d_ilp_data.matrix.d_values.size());
+            assert(isize(*p_row_values) == d_ilp_data.matrix.num_rows());
             d_ilp_data.matrix.append_column(*p_row_values);
         }
         else
         {
             assert(p_row_values->size() == p_row_indices->size());
-            assert(p_row_indices->size() <= d_ilp_data.matrix.d_values.size());
+            assert(isize(*p_row_indices) <= d_ilp_data.matrix.num_rows());
             d_ilp_data.matrix.append_column(*p_row_indices, *p_row_values);
         }
     }
@@ -232,14 +330,49 @@ void ILPSolverCollect::add_constraint_impl(double p_lower_bound, double p_upper_
 }
 
 
+void ILPSolverCollect::add_variables_impl(ValueArray p_objectives, ValueArray p_lower_bounds, ValueArray p_upper_bounds,
+                                          VariableTypeArray p_types, IndexArray p_col_starts, IndexArray p_row_indices,
+                                          ValueArray p_values)
+{
+    d_ilp_data.matrix.append_columns(isize(p_objectives), p_col_starts, p_row_indices, p_values);
+
+    d_ilp_data.objective.insert(d_ilp_data.objective.end(), p_objectives.begin(), p_objectives.end());
+    d_ilp_data.variable_lower.insert(d_ilp_data.variable_lower.end(), p_lower_bounds.begin(), p_lower_bounds.end());
+    d_ilp_data.variable_upper.insert(d_ilp_data.variable_upper.end(), p_upper_bounds.begin(), p_upper_bounds.end());
+    d_ilp_data.variable_type.insert(d_ilp_data.variable_type.end(), p_types.begin(), p_types.end());
+}
+
+
+void ILPSolverCollect::add_constraints_impl(ValueArray p_lower_bounds, ValueArray p_upper_bounds, IndexArray p_row_starts,
+                                            IndexArray p_col_indices, ValueArray p_values)
+{
+    assert(std::ranges::all_of(p_col_indices, [this](int p_index) { return p_index < get_num_variables(); }));
+    d_ilp_data.matrix.append_rows(p_row_starts, p_col_indices, p_values);
+
+    d_ilp_data.constraint_lower.insert(d_ilp_data.constraint_lower.end(), p_lower_bounds.begin(), p_lower_bounds.end());
+    d_ilp_data.constraint_upper.insert(d_ilp_data.constraint_upper.end(), p_upper_bounds.begin(), p_upper_bounds.end());
+}
+
+
 void ILPSolverCollect::set_objective_sense_impl(ObjectiveSense p_sense)
 {
     d_ilp_data.objective_sense = p_sense;
 }
 
 
+void ILPSolverCollect::prepare_impl()
+{
+    d_ilp_data.matrix.flush();
+}
+
+
+// Checked here, such that the stub need not start its solver process to reject the solution.
 void ILPSolverCollect::set_start_solution(ValueArray p_solution)
 {
+    assert(isize(p_solution) == get_num_variables());
+    d_ilp_data.matrix.flush();
+    if (!ModelEvaluator(make_view(d_ilp_data)).evaluate(p_solution).is_feasible())
+        throw InvalidStartSolutionException();
     d_ilp_data.start_solution.assign(p_solution.begin(), p_solution.end());
 }
 
@@ -303,4 +436,16 @@ void ILPSolverCollect::set_cutoff(double p_cutoff)
     d_ilp_data.cutoff = p_cutoff;
 }
 
+
+void ILPSolverCollect::set_interim_policy(const InterimPolicy& p_policy)
+{
+    d_ilp_data.interim_policy = p_policy;
+}
+
+
+void ILPSolverCollect::set_solver_parameter(const std::string& p_name, const std::string& p_value)
+{
+    d_ilp_data.add_solver_parameter(p_name, p_value);
+}
+
 } // namespace ilp_solver
@@ -4,6 +4,8 @@
 #include "ilp_solver_impl.hpp"
 
 #include <functional>
+#include <memory>
+#include <memory_resource>
 #include <string>
 
 namespace ilp_solver
@@ -23,7 +25,14 @@ public:
     void print_mps_file(const std::string& p_filename) override;
 protected:
     ILPSolverCollect();
+    // The arrays of d_ilp_data are allocated from p_memory_resource.
+    explicit ILPSolverCollect(std::unique_ptr<std::pmr::memory_resource> p_memory_resource);
 
+private:
+    // Must be declared before d_ilp_data, which allocates from it.
+    std::unique_ptr<std::pmr::memory_resource> d_memory_resource;
+
+protected:
     ILPData d_ilp_data;
 
 private:
@@ -34,8 +43,16 @@ private:
 
     void add_constraint_impl(double p_lower_bound, double p_upper_bound, ValueArray p_col_values,
                              const std::string& p_name = "", OptionalIndexArray p_col_indices = {}) override;
+    void add_variables_impl(ValueArray p_objectives, ValueArray p_lower_bounds, ValueArray p_upper_bounds,
+                            VariableTypeArray p_types, IndexArray p_col_starts, IndexArray p_row_indices,
+                            ValueArray p_values) override;
+    void add_constraints_impl(ValueArray p_lower_bounds, ValueArray p_upper_bounds, IndexArray p_row_starts,
+                              IndexArray p_col_indices, ValueArray p_values) override;
     void set_objective_sense_impl(ObjectiveSense p_sense) override;
 
+    // Merges the column entries collected by add_variable into the constraint matrix.
+    void prepare_impl() override;
+
     void set_start_solution     (ValueArray p_solution) override;
 
     void set_num_threads        (int p_num_threads)    override;
@@ -50,7 +67,11 @@ private:
     void set_max_rel_gap        (double p_gap)         override;
     void set_cutoff             (double p_cutoff)      override;
 
+    // Only stored; the solver that gets d_ilp_data checks the parameter.
+    void set_solver_parameter   (const std::string& p_name, const std::string& p_value) override;
+
     void set_interim_results    (std::function<void(ILPSolutionData*)>) override{ /* Not yet implemented. */ }
+    void set_interim_policy     (const InterimPolicy& p_policy) override;
 };
 
 } // namespace ilp_solver
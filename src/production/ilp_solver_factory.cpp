@@ -3,9 +3,14 @@
 #include "ilp_solver_cbc.hpp"
 #include "ilp_solver_gurobi.hpp"
 #include "ilp_solver_highs.hpp"
+#include "ilp_solver_portfolio.hpp"
 #include "ilp_solver_scip.hpp"
 #include "ilp_solver_stub.hpp"
 
+#include <cassert>
+#include <utility>
+#include <vector>
+
 
 namespace ilp_solver::impl
 {
@@ -48,6 +53,27 @@ extern "C" ILPSolverInterface* __stdcall create_solver_scip()
 }
 
 
+extern "C" ILPSolverInterface* __stdcall create_solver_by_backend(SolverBackend p_backend)
+{
+    switch (p_backend)
+    {
+        case SolverBackend::DEFAULT:
+            // In the order of all_solvers, whose second entry the stub solves with by default.
+            for (auto* create : {&create_solver_cbc, &create_solver_highs, &create_solver_scip, &create_solver_gurobi})
+            {
+                if (auto* solver = create())
+                    return solver;
+            }
+            return nullptr;
+        case SolverBackend::CBC:    return create_solver_cbc();
+        case SolverBackend::HIGHS:  return create_solver_highs();
+        case SolverBackend::SCIP:   return create_solver_scip();
+        case SolverBackend::GUROBI: return create_solver_gurobi();
+    }
+    return nullptr;
+}
+
+
 extern "C" ILPSolverInterface* __stdcall create_solver_stub([[maybe_unused]] const char* p_executable_basename,
                                                             [[maybe_unused]] bool        p_throw_on_all_crashes)
 {
@@ -59,6 +85,40 @@ extern "C" ILPSolverInterface* __stdcall create_solver_stub([[maybe_unused]] con
 }
 
 
+extern "C" ILPSolverInterface* __stdcall create_solver_stub_with_options([[maybe_unused]] const StubOptions* p_options)
+{
+#ifdef WITH_STUB
+    assert(p_options != nullptr && p_options->executable_basename != nullptr);
+    assert(p_options->num_racers >= 0 && (p_options->racers != nullptr || p_options->num_racers == 0));
+    return new ILPSolverStub(p_options->executable_basename, p_options->throw_on_all_crashes, p_options->num_workers,
+                             p_options->watchdog_policy, p_options->prelaunch, p_options->backend,
+                             std::vector<PortfolioRacer>(p_options->racers, p_options->racers + p_options->num_racers));
+#else
+    return nullptr;
+#endif
+}
+
+
+extern "C" ILPSolverInterface* __stdcall create_solver_portfolio(const PortfolioRacer* p_racers, int p_num_racers)
+{
+    assert(p_num_racers >= 0 && (p_racers != nullptr || p_num_racers == 0));
+    auto racers = std::vector<PortfolioRacer>(p_racers, p_racers + p_num_racers);
+    if (racers.empty())
+    {
+#ifdef WITH_CBC
+        racers.push_back({SolverBackend::CBC});
+#endif
+#if defined(WITH_HIGHS) && (_WIN64 == 1)
+        racers.push_back({SolverBackend::HIGHS});
+#endif
+#ifdef WITH_SCIP
+        racers.push_back({SolverBackend::SCIP});
+#endif
+    }
+    return racers.empty() ? nullptr : new ILPSolverPortfolio(std::move(racers));
+}
+
+
 extern "C" void __stdcall destroy_solver(ILPSolverInterface* p_solver)
 {
     delete p_solver;
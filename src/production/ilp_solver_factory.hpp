@@ -2,7 +2,14 @@
 
 #include "ilp_solver_interface.hpp"
 
+#include "platform.hpp"
+#include "portfolio_racer.hpp"
+#include "stub_options.hpp"
+#include "utility.hpp"
+#include "watchdog_policy.hpp"
+
 #include <memory>
+#include <vector>
 
 // List of all solvers usable from the .dll.
 // For new solvers, please follow the declarations below.
@@ -39,6 +46,9 @@ namespace impl
             ILPSolverInterface* __stdcall create_solver_highs();
 
 
+    extern "C" __declspec(dllexport) ILPSolverInterface* __stdcall create_solver_by_backend(SolverBackend p_backend);
+
+
     extern "C"
 #ifdef WITH_STUB
         __declspec(dllexport)
@@ -46,6 +56,17 @@ namespace impl
             ILPSolverInterface* __stdcall create_solver_stub(const char* p_executable_basename, bool p_throw_on_all_crashes);
 
 
+    extern "C"
+#ifdef WITH_STUB
+        __declspec(dllexport)
+#endif
+            ILPSolverInterface* __stdcall create_solver_stub_with_options(const StubOptions* p_options);
+
+
+    extern "C" __declspec(dllexport) ILPSolverInterface* __stdcall create_solver_portfolio(const PortfolioRacer* p_racers,
+                                                                                          int p_num_racers);
+
+
     extern "C" __declspec(dllexport) void __stdcall destroy_solver(ILPSolverInterface* p_solver);
 } // namespace impl
 
@@ -75,26 +96,102 @@ inline ScopedILPSolver create_solver_highs()
     return ScopedILPSolver(impl::create_solver_highs());
 }
 
+// Creates the in-process solver of p_backend, or returns nullptr if the library has not been built with it.
+// Constructing a solver may take a while, e.g. for loading the plugins of SCIP.
+// DEFAULT is the first of CBC, HiGHS, SCIP and Gurobi that is available, which is also the solver of a default stub.
+inline ScopedILPSolver create_solver(SolverBackend p_backend)
+{
+    return ScopedILPSolver(impl::create_solver_by_backend(p_backend));
+}
+
 inline ScopedILPSolver create_solver_stub(const char* p_executable_basename, bool p_throw_on_all_crashes)
 {
     return ScopedILPSolver(impl::create_solver_stub(p_executable_basename, p_throw_on_all_crashes));
 }
 
+// Creates a stub with all options at once, e.g. a prelaunched one of another backend (see StubOptions).
+inline ScopedILPSolver create_solver_stub(const StubOptions& p_options)
+{
+    return ScopedILPSolver(impl::create_solver_stub_with_options(&p_options));
+}
+
+// Like create_solver_stub, but the ILPs are solved by up to p_num_workers long-lived processes (see WorkerPool).
+inline ScopedILPSolver create_solver_stub_pooled(const char* p_executable_basename, bool p_throw_on_all_crashes, int p_num_workers)
+{
+    return create_solver_stub(StubOptions{.executable_basename  = p_executable_basename,
+                                          .throw_on_all_crashes = p_throw_on_all_crashes,
+                                          .num_workers          = p_num_workers});
+}
+
+// Like create_solver_stub, but the solver process is started right away and waits for the model, so that its
+// startup overlaps with building the model. The process is kept for further ILPs of the same solver.
+inline ScopedILPSolver create_solver_stub_prelaunched(const char* p_executable_basename, bool p_throw_on_all_crashes)
+{
+    return create_solver_stub(StubOptions{.executable_basename  = p_executable_basename,
+                                          .throw_on_all_crashes = p_throw_on_all_crashes,
+                                          .prelaunch            = true});
+}
+
+// Like create_solver_stub (p_num_workers == 0) or create_solver_stub_pooled, but with the given policy
+// for processes that exceed the time limit instead of the default one (see WatchdogPolicy).
+inline ScopedILPSolver create_solver_stub_watched(const char* p_executable_basename, bool p_throw_on_all_crashes,
+                                                  int p_num_workers, const WatchdogPolicy& p_watchdog_policy)
+{
+    return create_solver_stub(StubOptions{.executable_basename  = p_executable_basename,
+                                          .throw_on_all_crashes = p_throw_on_all_crashes,
+                                          .num_workers          = p_num_workers,
+                                          .watchdog_policy      = p_watchdog_policy});
+}
+
+// Like create_solver_stub (p_num_workers == 0) or create_solver_stub_pooled, but ScaiIlpExe solves with p_backend
+// instead of its default solver. Thus, one ScaiIlpExe serves stubs of all solvers it has been built with.
+inline ScopedILPSolver create_solver_stub_backend(const char* p_executable_basename, bool p_throw_on_all_crashes,
+                                                  int p_num_workers, SolverBackend p_backend)
+{
+    return create_solver_stub(StubOptions{.executable_basename  = p_executable_basename,
+                                          .throw_on_all_crashes = p_throw_on_all_crashes,
+                                          .num_workers          = p_num_workers,
+                                          .backend              = p_backend});
+}
+
+// Like create_solver_stub (p_num_workers == 0) or create_solver_stub_pooled, but each ILP is solved by one process
+// per racer at the same time. The first one that proves its result wins (see PortfolioRacer and PortfolioRace).
+// A racer that fails does not stop the others; its error is only reported if no racer has a solution.
+// A pool should have at least as many workers as there are racers, otherwise the racers wait for each other.
+inline ScopedILPSolver create_solver_stub_portfolio(const char* p_executable_basename, bool p_throw_on_all_crashes,
+                                                    int p_num_workers, const std::vector<PortfolioRacer>& p_racers)
+{
+    return create_solver_stub(StubOptions{.executable_basename  = p_executable_basename,
+                                          .throw_on_all_crashes = p_throw_on_all_crashes,
+                                          .num_workers          = p_num_workers,
+                                          .racers               = p_racers.data(),
+                                          .num_racers           = isize(p_racers)});
+}
+
+// Solves each ILP in this process with one solver per racer, each in its own thread (see ILPSolverPortfolio).
+// The race has the rules of the stub's portfolio (see PortfolioRace): In particular, a racer that throws does not stop
+// the others, and its exception is only rethrown if no racer has a solution.
+// Without racers, CBC, HiGHS and SCIP race, as far as they are available. Returns nullptr if none is.
+inline ScopedILPSolver create_solver_portfolio(const std::vector<PortfolioRacer>& p_racers = {})
+{
+    return ScopedILPSolver(impl::create_solver_portfolio(p_racers.data(), isize(p_racers)));
+}
+
 static const std::vector<std::pair<ScopedILPSolver(__stdcall*)(void), std::string_view>> all_solvers{
 #ifdef WITH_STUB // If enabled, Stub uses the second solver in this list.
     std::pair{[]() { return create_solver_stub("ScaiIlpExe.exe", false); }, "Stub"},
 #endif
 #ifdef WITH_CBC
-    std::pair{create_solver_cbc, "CBC"},
+    std::pair{&create_solver_cbc, "CBC"},
 #endif
 #if defined(WITH_HIGHS) && (_WIN64 == 1)
-    std::pair{create_solver_highs, "HiGHS"},
+    std::pair{&create_solver_highs, "HiGHS"},
 #endif
 #ifdef WITH_SCIP
-    std::pair{create_solver_scip, "SCIP"},
+    std::pair{&create_solver_scip, "SCIP"},
 #endif
 #if defined(WITH_GUROBI) && (_WIN64 == 1)
-    std::pair{create_solver_gurobi, "Gurobi"},
+    std::pair{&create_solver_gurobi, "Gurobi"},
 #endif
 };
 
@@ -3,10 +3,12 @@
 
 #include "ilp_solver_gurobi.hpp"
 
+#include "model_evaluator.hpp"
 #include "utility.hpp"
 
 #include <algorithm>
 #include <cassert>
+#include <vector>
 
 
 namespace ilp_solver
@@ -43,6 +45,101 @@ namespace
                 p_vec.push_back(i);
         }
     }
+
+
+    // The model of Gurobi in the arrays of a ModelEvaluator.
+    struct GurobiModel
+    {
+        std::vector<double>       objective;
+        std::vector<double>       variable_lower;
+        std::vector<double>       variable_upper;
+        std::vector<VariableType> variable_type;
+        std::vector<double>       constraint_lower;
+        std::vector<double>       constraint_upper;
+        std::vector<int>          row_starts{0};
+        std::vector<int>          col_indices;
+        std::vector<double>       values;
+
+        ModelEvaluator evaluator() const
+        {
+            return ModelEvaluator(objective, variable_lower, variable_upper, variable_type, constraint_lower,
+                                  constraint_upper, row_starts, col_indices, values);
+        }
+    };
+
+
+    // Reads the first p_num_vars variables and all constraints of the updated p_model.
+    // Like get_solution, this assumes that the variables of the user come first. Behind them, Gurobi adds a slack variable
+    // for each range constraint, which it stores as an equality constraint. The bounds of the slack give the range.
+    GurobiModel read_model(GRBmodel* p_model, int p_num_vars, int p_num_cons)
+    {
+        int num_all_vars{0};
+        call_gurobi(p_model, GRBgetintattr, p_model, GRB_INT_ATTR_NUMVARS, &num_all_vars);
+        std::vector<double> all_lower(num_all_vars);
+        std::vector<double> all_upper(num_all_vars);
+        std::vector<char>   types(p_num_vars);
+        call_gurobi(p_model, GRBgetdblattrarray,  p_model, GRB_DBL_ATTR_LB,      0, num_all_vars, all_lower.data());
+        call_gurobi(p_model, GRBgetdblattrarray,  p_model, GRB_DBL_ATTR_UB,      0, num_all_vars, all_upper.data());
+        call_gurobi(p_model, GRBgetcharattrarray, p_model, GRB_CHAR_ATTR_VTYPE,  0, p_num_vars,   types.data());
+
+        GurobiModel model;
+        model.objective.resize(p_num_vars);
+        call_gurobi(p_model, GRBgetdblattrarray, p_model, GRB_DBL_ATTR_OBJ, 0, p_num_vars, model.objective.data());
+        model.variable_lower.assign(all_lower.begin(), all_lower.begin() + p_num_vars);
+        model.variable_upper.assign(all_upper.begin(), all_upper.begin() + p_num_vars);
+        model.variable_type.resize(p_num_vars);
+        std::ranges::transform(types, model.variable_type.begin(), [](char p_type)
+        {
+            return (p_type == GRB_CONTINUOUS) ? VariableType::CONTINUOUS
+                 : (p_type == GRB_BINARY)     ? VariableType::BINARY
+                                              : VariableType::INTEGER;
+        });
+        if (p_num_cons == 0)
+            return model;
+
+        std::vector<double> rhs(p_num_cons);
+        std::vector<char>   senses(p_num_cons);
+        call_gurobi(p_model, GRBgetdblattrarray,  p_model, GRB_DBL_ATTR_RHS,    0, p_num_cons, rhs.data());
+        call_gurobi(p_model, GRBgetcharattrarray, p_model, GRB_CHAR_ATTR_SENSE, 0, p_num_cons, senses.data());
+
+        // The first call only determines the number of non-zeros.
+        std::size_t num_nonzeros{0};
+        call_gurobi(p_model, GRBXgetconstrs, p_model, &num_nonzeros, nullptr, nullptr, nullptr, 0, p_num_cons);
+        std::vector<std::size_t> starts(p_num_cons + 1);
+        std::vector<int>         indices(num_nonzeros);
+        std::vector<double>      values(num_nonzeros);
+        call_gurobi(p_model, GRBXgetconstrs, p_model, &num_nonzeros, starts.data(), indices.data(), values.data(), 0, p_num_cons);
+        starts[p_num_cons] = num_nonzeros;
+
+        model.col_indices.reserve(num_nonzeros);
+        model.values.reserve(num_nonzeros);
+        for (auto i = 0; i < p_num_cons; ++i)
+        {
+            auto lower = (senses[i] == GRB_LESS_EQUAL)    ? c_neg_inf : rhs[i];
+            auto upper = (senses[i] == GRB_GREATER_EQUAL) ? c_pos_inf : rhs[i];
+            for (auto k = starts[i]; k < starts[i + 1]; ++k)
+            {
+                const auto col = indices[k];
+                if (col < p_num_vars)
+                {
+                    model.col_indices.push_back(col);
+                    model.values.push_back(values[k]);
+                }
+                else
+                {
+                    // a*x + factor*slack = rhs with the slack within its bounds.
+                    const auto at_lower = values[k]*all_lower[col];
+                    const auto at_upper = values[k]*all_upper[col];
+                    lower = rhs[i] - std::max(at_lower, at_upper);
+                    upper = rhs[i] - std::min(at_lower, at_upper);
+                }
+            }
+            model.constraint_lower.push_back(lower);
+            model.constraint_upper.push_back(upper);
+            model.row_starts.push_back(isize(model.values));
+        }
+        return model;
+    }
 }
 
 
@@ -58,6 +155,24 @@ ILPSolverGurobi::ILPSolverGurobi()
         throw std::runtime_error("Gurobi Error: \"Could not create a new model.\"");
 
     set_default_parameters(this);
+    call_gurobi(d_model, GRBsetcallbackfunc, d_model, callback, this);
+}
+
+
+int __stdcall ILPSolverGurobi::callback(GRBmodel* p_model, void* p_cbdata, int p_where, void* p_usrdata)
+{
+    const auto solver = static_cast<const ILPSolverGurobi*>(p_usrdata);
+    if (p_where == GRB_CB_MIP)
+    {
+        double num_nodes;
+        double best_bound;
+        if (GRBcbget(p_cbdata, p_where, GRB_CB_MIP_NODCNT, &num_nodes) == 0
+            && GRBcbget(p_cbdata, p_where, GRB_CB_MIP_OBJBND, &best_bound) == 0)
+            solver->report_progress({static_cast<long long>(num_nodes), best_bound});
+    }
+    if (solver->stop_requested())
+        GRBterminate(p_model);
+    return 0;
 }
 
 
@@ -150,23 +265,13 @@ SolutionStatus ILPSolverGurobi::get_status() const
 void ILPSolverGurobi::set_start_solution(ValueArray p_solution)
 {
     assert(isize(p_solution) == d_num_vars);
-    // Check feasibility of the start solution by optimizing with all variables fixed and
-    // throw an InvalidStartSolutionException if it is not.
-    // Needs to backup and afterwards restore the lower and upper bounds on the variables.
+    // Checks the start solution against the model of Gurobi, which is much faster than solving with all variables fixed,
+    // and throws an InvalidStartSolutionException if it is not feasible.
     call_gurobi(d_model, GRBupdatemodel, d_model);
-    std::vector<double> lb(d_num_vars);
-    std::vector<double> ub(d_num_vars);
-    call_gurobi(d_model, GRBgetdblattrarray, d_model, GRB_DBL_ATTR_LB,    0, d_num_vars, lb.data());
-    call_gurobi(d_model, GRBgetdblattrarray, d_model, GRB_DBL_ATTR_UB,    0, d_num_vars, ub.data());
-    call_gurobi(d_model, GRBsetdblattrarray, d_model, GRB_DBL_ATTR_LB,    0, d_num_vars, const_cast<double*>(p_solution.data()));
-    call_gurobi(d_model, GRBsetdblattrarray, d_model, GRB_DBL_ATTR_UB,    0, d_num_vars, const_cast<double*>(p_solution.data()));
-    solve_impl();
-    SolutionStatus status = get_status();
-    call_gurobi(d_model, GRBsetdblattrarray, d_model, GRB_DBL_ATTR_LB,    0, d_num_vars, lb.data());
-    call_gurobi(d_model, GRBsetdblattrarray, d_model, GRB_DBL_ATTR_UB,    0, d_num_vars, ub.data());
-    call_gurobi(d_model, GRBsetdblattrarray, d_model, GRB_DBL_ATTR_START, 0, d_num_vars, const_cast<double*>(p_solution.data()));
-    if (status == SolutionStatus::PROVEN_INFEASIBLE)
+    const auto model = read_model(d_model, d_num_vars, d_num_cons);
+    if (!model.evaluator().evaluate(p_solution).is_feasible())
         throw InvalidStartSolutionException();
+    call_gurobi(d_model, GRBsetdblattrarray, d_model, GRB_DBL_ATTR_START, 0, d_num_vars, const_cast<double*>(p_solution.data()));
 }
 
 
@@ -258,6 +363,12 @@ void ILPSolverGurobi::set_cutoff(double p_cutoff)
 }
 
 
+void ILPSolverGurobi::set_solver_parameter(const std::string& p_name, const std::string& p_value)
+{
+    call_gurobi(d_model, GRBsetparam, GRBgetenv(d_model), p_name.c_str(), p_value.c_str());
+}
+
+
 void ILPSolverGurobi::print_mps_file(const std::string& p_filename)
 {
     assert(p_filename.substr(p_filename.size() - 4, 4) == ".mps");
@@ -346,6 +457,84 @@ void ILPSolverGurobi::add_constraint_impl(double p_lower_bound, double p_upper_b
 }
 
 
+void ILPSolverGurobi::add_variables_impl(ValueArray p_objectives, ValueArray p_lower_bounds, ValueArray p_upper_bounds,
+                                         VariableTypeArray p_types, IndexArray p_col_starts, IndexArray p_row_indices,
+                                         ValueArray p_values)
+{
+    const auto num_variables = isize(p_objectives);
+
+    std::vector<char> types(num_variables);
+    std::ranges::transform(p_types, types.begin(), [](VariableType p_type)
+    {
+        return (p_type == VariableType::INTEGER)    ? GRB_INTEGER
+             : (p_type == VariableType::CONTINUOUS) ? GRB_CONTINUOUS
+                                                    : GRB_BINARY;
+    });
+
+    // Gurobi is not const-correct, but copies all arrays.
+    call_gurobi(d_model, GRBaddvars, d_model, num_variables, isize(p_values),
+                p_col_starts.empty() ? nullptr : const_cast<int*>(p_col_starts.data()),
+                const_cast<int*>(p_row_indices.data()), const_cast<double*>(p_values.data()),
+                const_cast<double*>(p_objectives.data()), const_cast<double*>(p_lower_bounds.data()),
+                const_cast<double*>(p_upper_bounds.data()), types.data(), nullptr);
+    d_num_vars += num_variables;
+}
+
+
+// Gurobi takes range constraints by a separate function, so consecutive constraints of the same kind are added by one call.
+void ILPSolverGurobi::add_constraints_impl(ValueArray p_lower_bounds, ValueArray p_upper_bounds, IndexArray p_row_starts,
+                                           IndexArray p_col_indices, ValueArray p_values)
+{
+    const auto num_constraints = isize(p_lower_bounds);
+    auto is_range = [&](int i)
+    {
+        return p_lower_bounds[i] != p_upper_bounds[i] && p_lower_bounds[i] >= c_neg_inf_bound && p_upper_bounds[i] <= c_pos_inf_bound;
+    };
+
+    std::vector<int>    row_starts;
+    std::vector<char>   senses;
+    std::vector<double> right_hand_sides;
+    for (int begin = 0; begin < num_constraints;)
+    {
+        const auto range = is_range(begin);
+        auto       end   = begin + 1;
+        while (end < num_constraints && is_range(end) == range)
+            ++end;
+
+        const auto num   = end - begin;
+        const auto first = p_row_starts[begin];
+        row_starts.resize(num);
+        std::ranges::transform(p_row_starts.subspan(begin, num), row_starts.begin(), [first](int p_start) { return p_start - first; });
+        auto* indices = const_cast<int*>(p_col_indices.data()) + first;
+        auto* values  = const_cast<double*>(p_values.data()) + first;
+
+        // Gurobi is not const-correct, but copies all arrays.
+        if (range)
+        {
+            call_gurobi(d_model, GRBaddrangeconstrs, d_model, num, p_row_starts[end] - first, row_starts.data(), indices, values,
+                        const_cast<double*>(p_lower_bounds.data()) + begin, const_cast<double*>(p_upper_bounds.data()) + begin, nullptr);
+        }
+        else
+        {
+            // The constraints without finite bounds have been skipped by ILPSolverImpl::add_constraints.
+            senses.resize(num);
+            right_hand_sides.resize(num);
+            for (int i = 0; i < num; ++i)
+            {
+                const auto lower = p_lower_bounds[begin + i];
+                const auto upper = p_upper_bounds[begin + i];
+                senses[i]           = (lower == upper) ? GRB_EQUAL : (lower >= c_neg_inf_bound) ? GRB_GREATER_EQUAL : GRB_LESS_EQUAL;
+                right_hand_sides[i] = (lower >= c_neg_inf_bound) ? lower : upper;
+            }
+            call_gurobi(d_model, GRBaddconstrs, d_model, num, p_row_starts[end] - first, row_starts.data(), indices, values,
+                        senses.data(), right_hand_sides.data(), nullptr);
+        }
+        d_num_cons += num;
+        begin = end;
+    }
+}
+
+
 void ILPSolverGurobi::solve_impl()
 {
     call_gurobi(d_model, GRBoptimize, d_model);
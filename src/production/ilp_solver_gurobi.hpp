@@ -43,6 +43,9 @@ namespace ilp_solver
             void set_max_rel_gap       (double p_gap)                           override;
             void set_cutoff            (double p_cutoff)                        override;
 
+            // Any parameter of Gurobi, e.g. "MIPFocus". Gurobi converts the value to the type of the parameter.
+            void set_solver_parameter  (const std::string& p_name, const std::string& p_value) override;
+
             void print_mps_file        (const std::string& p_filename)          override;
 
             void set_interim_results   (std::function<void(ILPSolutionData*)>)  override { /* Not yet implemented*/ }
@@ -62,6 +65,16 @@ namespace ilp_solver
             void add_constraint_impl(double p_lower_bound, double p_upper_bound, ValueArray p_col_values,
                                      const std::string& p_name = "", OptionalIndexArray p_col_indices = {}) override;
 
+            void add_variables_impl (ValueArray p_objectives, ValueArray p_lower_bounds, ValueArray p_upper_bounds,
+                                     VariableTypeArray p_types, IndexArray p_col_starts, IndexArray p_row_indices,
+                                     ValueArray p_values) override;
+
+            void add_constraints_impl(ValueArray p_lower_bounds, ValueArray p_upper_bounds, IndexArray p_row_starts,
+                                      IndexArray p_col_indices, ValueArray p_values) override;
+
+            // Called by Gurobi regularly during GRBoptimize. p_usrdata is the ILPSolverGurobi.
+            static int __stdcall callback(GRBmodel* p_model, void* p_cbdata, int p_where, void* p_usrdata);
+
             void solve_impl              ()                       override;
             void set_objective_sense_impl(ObjectiveSense p_sense) override;
             void set_max_seconds_impl    (double p_seconds)       override;
@@ -2,10 +2,16 @@
 
 #include "ilp_solver_highs.hpp"
 
+#include "ilp_data.hpp"
+#include "model_evaluator.hpp"
 #include "utility.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <format>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 // Assert that a call to a HiGHS function did return OK.
 // Wrapping this in a function instead of a macro would result in way less readable error messages, sadly.
@@ -22,11 +28,57 @@ ILPSolverHighs::ILPSolverHighs()
 {
     set_default_parameters(this);
 
-    // Disable presolve to enforce the time limit, as presolve does not respect it
-    // see https://github.com/ERGO-Code/HiGHS/issues/1278
-    set_presolve(false);
-    ASSERT_OK(d_highs.setOptionValue("presolve_reduction_limit", 0));
-    ASSERT_OK(d_highs.setOptionValue("restart_presolve_reduction_limit", 0));
+    ASSERT_OK(d_highs.setCallback([this](int p_callback_type, const std::string&, const HighsCallbackDataOut* p_data_out,
+                                         HighsCallbackDataIn* r_data_in, void*)
+                                  { handle_callback(p_callback_type, p_data_out, r_data_in); }));
+    // HiGHS asks the interrupt callbacks regularly during simplex, IPM and branch & bound.
+    // There, stop_requested enforces the time limit, also where HiGHS itself overruns it.
+    // HiGHS does not call them during presolve, which only its own time limit ends (see solve_impl). Thus, presolve can stay on.
+    ASSERT_OK(d_highs.startCallback(kCallbackSimplexInterrupt));
+    ASSERT_OK(d_highs.startCallback(kCallbackIpmInterrupt));
+    ASSERT_OK(d_highs.startCallback(kCallbackMipInterrupt));
+}
+
+
+void ILPSolverHighs::handle_callback(int p_callback_type, const HighsCallbackDataOut* p_data_out,
+                                     HighsCallbackDataIn* r_data_in)
+{
+    switch (p_callback_type)
+    {
+    case kCallbackMipInterrupt:
+        report_progress({static_cast<long long>(p_data_out->mip_node_count), p_data_out->mip_dual_bound});
+        [[fallthrough]];
+    case kCallbackSimplexInterrupt: [[fallthrough]];
+    case kCallbackIpmInterrupt:
+        d_interim.poll();
+        r_data_in->user_interrupt = stop_requested();
+        break;
+    case kCallbackMipImprovingSolution:
+        // The solution is of the original model, not of the presolved one.
+        if (p_data_out->mip_solution != nullptr)
+        {
+            const auto solution = p_data_out->mip_solution;
+            d_interim.offer(p_data_out->objective_function_value,
+                            [solution, this](double* r_values)
+                            {
+                                std::copy_n(solution, d_highs.getNumCol(), r_values);
+                                return true;
+                            });
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+
+void ILPSolverHighs::set_interim_results(std::function<void(ILPSolutionData*)> p_interim_handler)
+{
+    d_interim.set_handler(std::move(p_interim_handler));
+    if (d_interim.has_handler())
+        ASSERT_OK(d_highs.startCallback(kCallbackMipImprovingSolution));
+    else
+        ASSERT_OK(d_highs.stopCallback(kCallbackMipImprovingSolution));
 }
 
 
@@ -102,20 +154,26 @@ SolutionStatus ILPSolverHighs::get_status() const
 
 void ILPSolverHighs::set_start_solution(ValueArray p_solution)
 {
+    assert(isize(p_solution) == get_num_variables());
+    // setSolution only rejects solutions of an invalid size, so the solution is checked against the model of HiGHS.
+    // The evaluator needs the matrix row by row, but HiGHS usually stores it column by column.
+    const auto& lp     = d_highs.getLp();
+    auto        matrix = lp.a_matrix_;
+    matrix.ensureRowwise();
+    std::vector<VariableType> types(lp.num_col_, VariableType::CONTINUOUS);
+    for (auto j = 0; j < isize(lp.integrality_); ++j)
+    {
+        if (lp.integrality_[j] == HighsVarType::kInteger)
+            types[j] = VariableType::INTEGER;
+    }
+    const ModelEvaluator evaluator(lp.col_cost_, lp.col_lower_, lp.col_upper_, types, lp.row_lower_, lp.row_upper_,
+                                   matrix.start_, matrix.index_, matrix.value_);
+    if (!evaluator.evaluate(p_solution).is_feasible())
+        throw InvalidStartSolutionException();
+
     HighsSolution new_solution{};
     new_solution.col_value.assign(p_solution.begin(), p_solution.end());
-    auto set_solution_status = d_highs.setSolution(new_solution);
-    // Note that d_highs.getSolution().value_valid will be true for infeasible solutions.
-    // Also, setSolution will only reject solutions that have an invalid size.
-    // Therefore, we do the additional call to assessPrimalSolution to validate it.
-    // It is not documented what exactly the bool parameters represent, but checking them all seems reasonable.
-    // Also assessPrimalSolution seems to return kWarning if any of the bools are false.
-    bool valid                  = false;
-    bool integral               = false;
-    bool feasible               = false;
-    auto assess_solution_status = d_highs.assessPrimalSolution(valid, integral, feasible);
-    if (set_solution_status != HighsStatus::kOk || !d_highs.getSolution().value_valid
-        || assess_solution_status != HighsStatus::kOk || !valid || !integral || !feasible)
+    if (d_highs.setSolution(new_solution) != HighsStatus::kOk)
         throw InvalidStartSolutionException();
 }
 
@@ -194,6 +252,14 @@ void ILPSolverHighs::set_cutoff(double p_cutoff)
 }
 
 
+void ILPSolverHighs::set_solver_parameter(const std::string& p_name, const std::string& p_value)
+{
+    // HiGHS converts the value to the type of the option itself.
+    if (d_highs.setOptionValue(p_name, p_value) != HighsStatus::kOk)
+        throw std::runtime_error(std::format("HiGHS Error: Cannot set option \"{}\" to \"{}\".", p_name, p_value));
+}
+
+
 void ILPSolverHighs::print_mps_file(const std::string& p_filename)
 {
     assert(p_filename.substr(p_filename.size() - 4, 4) == ".mps");
@@ -258,9 +324,62 @@ void ILPSolverHighs::add_constraint_impl(double p_lower_bound, double p_upper_bo
 }
 
 
+void ILPSolverHighs::add_variables_impl(ValueArray p_objectives, ValueArray p_lower_bounds, ValueArray p_upper_bounds,
+                                        VariableTypeArray p_types, IndexArray p_col_starts, IndexArray p_row_indices,
+                                        ValueArray p_values)
+{
+    const auto num_variables = isize(p_objectives);
+    const auto first_col_idx = d_highs.getNumCol();
+    // HiGHS expects one start per column (without the final entry), which is a prefix of our CSC starts.
+    ASSERT_OK(d_highs.addCols(num_variables, p_objectives.data(), p_lower_bounds.data(), p_upper_bounds.data(),
+                              isize(p_values), p_col_starts.empty() ? nullptr : p_col_starts.data(),
+                              p_row_indices.data(), p_values.data()));
+
+    // HiGHS has no binary variables, so we use integral variables bounded by 0 and 1.
+    std::vector<HighsVarType> integrality(num_variables);
+    std::ranges::transform(p_types, integrality.begin(), [](VariableType p_type)
+                           { return p_type == VariableType::CONTINUOUS ? HighsVarType::kContinuous : HighsVarType::kInteger; });
+    ASSERT_OK(d_highs.changeColsIntegrality(first_col_idx, first_col_idx + num_variables - 1, integrality.data()));
+}
+
+
+void ILPSolverHighs::add_constraints_impl(ValueArray p_lower_bounds, ValueArray p_upper_bounds, IndexArray p_row_starts,
+                                          IndexArray p_col_indices, ValueArray p_values)
+{
+    ASSERT_OK(d_highs.addRows(isize(p_lower_bounds), p_lower_bounds.data(), p_upper_bounds.data(), isize(p_values),
+                              p_row_starts.data(), p_col_indices.data(), p_values.data()));
+}
+
+
+// passModel replaces the whole (empty) model at once, which saves HiGHS the checks and reallocations of adding to it.
+void ILPSolverHighs::load_model_impl(const ILPDataView& p_model)
+{
+    const auto& matrix = p_model.matrix;
+    std::vector<HighsInt> integrality(p_model.variable_type.size());
+    std::ranges::transform(p_model.variable_type, integrality.begin(), [](VariableType p_type)
+                           { return static_cast<HighsInt>(p_type == VariableType::CONTINUOUS ? HighsVarType::kContinuous
+                                                                                             : HighsVarType::kInteger); });
+
+    // Keep the objective sense, which may have been set before.
+    ASSERT_OK(d_highs.passModel(isize(p_model.objective), isize(p_model.constraint_lower), isize(matrix.d_values),
+                                static_cast<HighsInt>(MatrixFormat::kRowwise), static_cast<HighsInt>(d_highs.getLp().sense_),
+                                0., p_model.objective.data(), p_model.variable_lower.data(), p_model.variable_upper.data(),
+                                p_model.constraint_lower.data(), p_model.constraint_upper.data(),
+                                matrix.d_row_starts.empty() ? nullptr : matrix.d_row_starts.data(),
+                                matrix.d_indices.data(), matrix.d_values.data(), integrality.data()));
+}
+
+
 void ILPSolverHighs::solve_impl()
 {
+    const auto sense = d_highs.getLp().sense_ == ObjSense::kMaximize ? ObjectiveSense::MAXIMIZE : ObjectiveSense::MINIMIZE;
+    d_interim.start(d_interim_policy, sense, d_highs.getNumCol());
+    // The time limit of HiGHS counts from run(), the one of ScaiIlp from minimize() or maximize().
+    // So HiGHS gets the time left, such that a presolve, which no interrupt callback can end, ends by the deadline as well
+    // (see https://github.com/ERGO-Code/HiGHS/issues/1278 for presolve overrunning the time limit of older versions).
+    ASSERT_OK(d_highs.setOptionValue("time_limit", seconds_left()));
     [[maybe_unused]] const auto status = d_highs.run();
+    d_interim.finish();
     // status will be HighsStatus::kWarning if the function was aborted early
     // due to some time, iteration or solution limit. (See HiGHS internal function highsStatusFromHighsModelStatus.)
     // So we only assert that it is not an error.
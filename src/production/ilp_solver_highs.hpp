@@ -4,8 +4,10 @@
 #if defined(WITH_HIGHS) && (_WIN64 == 1)
 
 #include "ilp_solver_impl.hpp"
+#include "interim_delivery.hpp"
 
 #include <Highs.h>
+#include <functional>
 
 #pragma comment(lib, "highs.lib")
 
@@ -42,11 +44,14 @@ public:
     void set_max_rel_gap(double p_gap) override;
     void set_cutoff(double p_cutoff) override;
 
+    // Any option of HiGHS, see https://ergo-code.github.io/HiGHS/dev/options/definitions/
+    void set_solver_parameter(const std::string& p_name, const std::string& p_value) override;
+
     void print_mps_file(const std::string& p_filename) override;
 
-    void set_interim_results(std::function<void(ILPSolutionData*)>) override
-    { /* Not yet implemented*/
-    }
+    // Like the event handler of CBC, MIP solutions that improve on the last one are passed to p_interim_handler
+    // as the interim policy says.
+    void set_interim_results(std::function<void(ILPSolutionData*)> p_interim_handler) override;
 
 private:
     void add_variable_impl(VariableType p_type, double p_objective, double p_lower_bound, double p_upper_bound,
@@ -57,12 +62,23 @@ private:
     void add_constraint_impl(double p_lower_bound, double p_upper_bound, ValueArray p_col_values,
                              const std::string& p_name = "", OptionalIndexArray p_col_indices = {}) override;
 
+    void add_variables_impl(ValueArray p_objectives, ValueArray p_lower_bounds, ValueArray p_upper_bounds,
+                            VariableTypeArray p_types, IndexArray p_col_starts, IndexArray p_row_indices,
+                            ValueArray p_values) override;
+    void add_constraints_impl(ValueArray p_lower_bounds, ValueArray p_upper_bounds, IndexArray p_row_starts,
+                              IndexArray p_col_indices, ValueArray p_values) override;
+    void load_model_impl(const ILPDataView& p_model) override;
+
     void solve_impl() override;
     void set_objective_sense_impl(ObjectiveSense p_sense) override;
     void set_max_seconds_impl(double p_seconds) override;
 
+    // Called by HiGHS for each callback type started in the constructor.
+    void handle_callback(int p_callback_type, const HighsCallbackDataOut* p_data_out, HighsCallbackDataIn* r_data_in);
+
     // The Highs object holds the model, solution and all options.
     Highs d_highs{};
+    InterimDelivery d_interim;
     // Helper object for dense -> sparse conversions.
     SparseVec d_sparse{};
 };
@@ -1,9 +1,16 @@
 #include "ilp_solver_impl.hpp"
 
+#include "ilp_data.hpp"
+
 #include "utility.hpp"
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 
 namespace ilp_solver
@@ -175,6 +182,172 @@ void ILPSolverImpl::add_constraint_equality(IndexArray p_col_indices, ValueArray
 }
 
 
+// Same as add_constraint: Constraints without any finite bound are skipped.
+static bool is_free_constraint(double p_lower_bound, double p_upper_bound)
+{
+    return p_upper_bound > c_pos_inf_bound && p_lower_bound < c_neg_inf_bound;
+}
+
+
+static void check_variables([[maybe_unused]] ValueArray p_objectives, [[maybe_unused]] ValueArray p_lower_bounds,
+                            [[maybe_unused]] ValueArray p_upper_bounds, [[maybe_unused]] VariableTypeArray p_types,
+                            [[maybe_unused]] IndexArray p_col_starts, [[maybe_unused]] IndexArray p_row_indices,
+                            [[maybe_unused]] ValueArray p_values)
+{
+    [[maybe_unused]] const auto num_variables = isize(p_objectives);
+    assert(isize(p_lower_bounds) == num_variables);
+    assert(isize(p_upper_bounds) == num_variables);
+    assert(isize(p_types) == num_variables);
+    assert(p_row_indices.size() == p_values.size());
+    assert(p_col_starts.empty() ? p_values.empty()
+                                : isize(p_col_starts) == num_variables + 1 && p_col_starts.front() == 0
+                                      && p_col_starts.back() == isize(p_values));
+    assert(std::ranges::all_of(std::views::iota(0, num_variables), [&](int j)
+           { return p_types[j] != VariableType::BINARY || (p_lower_bounds[j] == 0. && p_upper_bounds[j] == 1.); }));
+}
+
+
+static void check_constraints([[maybe_unused]] ValueArray p_lower_bounds, [[maybe_unused]] ValueArray p_upper_bounds,
+                              [[maybe_unused]] IndexArray p_row_starts, [[maybe_unused]] IndexArray p_col_indices,
+                              [[maybe_unused]] ValueArray p_values)
+{
+    [[maybe_unused]] const auto num_constraints = isize(p_lower_bounds);
+    assert(isize(p_upper_bounds) == num_constraints);
+    assert(p_col_indices.size() == p_values.size());
+    assert(num_constraints == 0
+           || (isize(p_row_starts) == num_constraints + 1 && p_row_starts.front() == 0 && p_row_starts.back() == isize(p_values)));
+}
+
+
+void ILPSolverImpl::add_variables(ValueArray p_objectives, ValueArray p_lower_bounds, ValueArray p_upper_bounds,
+                                  VariableTypeArray p_types, IndexArray p_col_starts, IndexArray p_row_indices,
+                                  ValueArray p_values)
+{
+    check_variables(p_objectives, p_lower_bounds, p_upper_bounds, p_types, p_col_starts, p_row_indices, p_values);
+
+    if (p_objectives.empty())
+        return;
+    add_variables_impl(p_objectives, p_lower_bounds, p_upper_bounds, p_types, p_col_starts, p_row_indices, p_values);
+}
+
+
+void ILPSolverImpl::add_constraints(ValueArray p_lower_bounds, ValueArray p_upper_bounds, IndexArray p_row_starts,
+                                    IndexArray p_col_indices, ValueArray p_values)
+{
+    check_constraints(p_lower_bounds, p_upper_bounds, p_row_starts, p_col_indices, p_values);
+
+    const auto num_constraints = isize(p_lower_bounds);
+    if (num_constraints == 0)
+        return;
+
+    auto is_free = [&](int i) { return is_free_constraint(p_lower_bounds[i], p_upper_bounds[i]); };
+    const auto num_free = std::ranges::count_if(std::views::iota(0, num_constraints), is_free);
+    if (num_free == 0)
+    {
+        add_constraints_impl(p_lower_bounds, p_upper_bounds, p_row_starts, p_col_indices, p_values);
+        return;
+    }
+
+    std::vector<double> lower_bounds;
+    std::vector<double> upper_bounds;
+    std::vector<int>    row_starts{0};
+    std::vector<int>    col_indices;
+    std::vector<double> values;
+    lower_bounds.reserve(num_constraints - num_free);
+    upper_bounds.reserve(num_constraints - num_free);
+    row_starts.reserve(num_constraints - num_free + 1);
+    for (int i = 0; i < num_constraints; ++i)
+    {
+        if (is_free(i))
+            continue;
+        lower_bounds.push_back(p_lower_bounds[i]);
+        upper_bounds.push_back(p_upper_bounds[i]);
+        const auto begin = p_row_starts[i];
+        const auto end   = p_row_starts[i + 1];
+        col_indices.insert(col_indices.end(), p_col_indices.begin() + begin, p_col_indices.begin() + end);
+        values.insert(values.end(), p_values.begin() + begin, p_values.begin() + end);
+        row_starts.push_back(isize(values));
+    }
+
+    if (!lower_bounds.empty())
+        add_constraints_impl(lower_bounds, upper_bounds, row_starts, col_indices, values);
+}
+
+
+void ILPSolverImpl::load_model(const ILPDataView& p_model)
+{
+    const auto& matrix = p_model.matrix;
+    check_variables(p_model.objective, p_model.variable_lower, p_model.variable_upper, p_model.variable_type, {}, {}, {});
+    check_constraints(p_model.constraint_lower, p_model.constraint_upper, matrix.d_row_starts, matrix.d_indices, matrix.d_values);
+    assert(matrix.d_num_cols <= isize(p_model.objective));
+
+    const auto has_free_constraint = std::ranges::any_of(std::views::iota(0, isize(p_model.constraint_lower)), [&](int i)
+                                     { return is_free_constraint(p_model.constraint_lower[i], p_model.constraint_upper[i]); });
+    if (get_num_variables() == 0 && get_num_constraints() == 0 && !has_free_constraint)
+    {
+        load_model_impl(p_model);
+        return;
+    }
+
+    const auto num_previous_variables = get_num_variables();
+    add_variables(p_model.objective, p_model.variable_lower, p_model.variable_upper, p_model.variable_type);
+    if (num_previous_variables == 0)
+    {
+        add_constraints(p_model.constraint_lower, p_model.constraint_upper, matrix.d_row_starts, matrix.d_indices, matrix.d_values);
+        return;
+    }
+
+    // The column indices of p_model refer to its own variables, which come after the existing ones.
+    std::vector<int> col_indices(matrix.d_indices.begin(), matrix.d_indices.end());
+    for (auto& index : col_indices)
+        index += num_previous_variables;
+    add_constraints(p_model.constraint_lower, p_model.constraint_upper, matrix.d_row_starts, col_indices, matrix.d_values);
+}
+
+
+void ILPSolverImpl::add_variables_impl(ValueArray p_objectives, ValueArray p_lower_bounds, ValueArray p_upper_bounds,
+                                       VariableTypeArray p_types, IndexArray p_col_starts, IndexArray p_row_indices,
+                                       ValueArray p_values)
+{
+    for (int j = 0; j < isize(p_objectives); ++j)
+    {
+        if (p_col_starts.empty())
+        {
+            add_variable_impl(p_types[j], p_objectives[j], p_lower_bounds[j], p_upper_bounds[j]);
+            continue;
+        }
+
+        const auto begin = p_col_starts[j];
+        const auto size  = p_col_starts[j + 1] - begin;
+        add_variable_impl(p_types[j], p_objectives[j], p_lower_bounds[j], p_upper_bounds[j], "",
+                          p_values.subspan(begin, size), p_row_indices.subspan(begin, size));
+    }
+}
+
+
+void ILPSolverImpl::add_constraints_impl(ValueArray p_lower_bounds, ValueArray p_upper_bounds, IndexArray p_row_starts,
+                                         IndexArray p_col_indices, ValueArray p_values)
+{
+    for (int i = 0; i < isize(p_lower_bounds); ++i)
+    {
+        const auto begin = p_row_starts[i];
+        const auto size  = p_row_starts[i + 1] - begin;
+        add_constraint_impl(p_lower_bounds[i], p_upper_bounds[i], p_values.subspan(begin, size), "",
+                            p_col_indices.subspan(begin, size));
+    }
+}
+
+
+void ILPSolverImpl::load_model_impl(const ILPDataView& p_model)
+{
+    if (!p_model.objective.empty())
+        add_variables_impl(p_model.objective, p_model.variable_lower, p_model.variable_upper, p_model.variable_type, {}, {}, {});
+    if (!p_model.constraint_lower.empty())
+        add_constraints_impl(p_model.constraint_lower, p_model.constraint_upper, p_model.matrix.d_row_starts,
+                             p_model.matrix.d_indices, p_model.matrix.d_values);
+}
+
+
 void ILPSolverImpl::set_max_seconds(double p_seconds)
 {
     d_max_seconds = p_seconds;
@@ -182,29 +355,65 @@ void ILPSolverImpl::set_max_seconds(double p_seconds)
 }
 
 
+void ILPSolverImpl::set_stop_condition(std::function<bool()> p_stop_condition)
+{
+    d_stop_condition = std::move(p_stop_condition);
+}
+
+
+void ILPSolverImpl::request_stop()
+{
+    d_stop_request = true;
+}
+
+
+void ILPSolverImpl::set_progress_handler(std::function<void(const SolverProgress&)> p_progress_handler)
+{
+    d_progress_handler = std::move(p_progress_handler);
+}
+
+
+void ILPSolverImpl::set_solver_parameter(const std::string& p_name, [[maybe_unused]] const std::string& p_value)
+{
+    throw std::runtime_error("Cannot set solver parameter \"" + p_name + "\": The solver does not support parameters by name.");
+}
+
+
 void ILPSolverImpl::prepare_impl()
 {}
 
 
-void ILPSolverImpl::minimize()
+void ILPSolverImpl::solve(ObjectiveSense p_sense)
 {
-    if (d_max_seconds <= 0)
-        return;
+    d_deadline = d_enforce_max_seconds ? time_after(std::chrono::steady_clock::now(), d_max_seconds)
+                                       : std::chrono::steady_clock::time_point::max();
+    try
+    {
+        if (d_max_seconds > 0)
+        {
+            prepare_impl();
+            set_objective_sense_impl(p_sense);
+            solve_impl();
+        }
+    }
+    catch (...)
+    {
+        d_stop_request = false;
+        throw;
+    }
+    d_stop_request = false;
+}
 
-    prepare_impl();
-    set_objective_sense_impl(ObjectiveSense::MINIMIZE);
-    solve_impl();
+
+void ILPSolverImpl::minimize()
+{
+    solve(ObjectiveSense::MINIMIZE);
 }
 
 
 void ILPSolverImpl::maximize()
 {
-    if (d_max_seconds <= 0)
-        return;
-
-    prepare_impl();
-    set_objective_sense_impl(ObjectiveSense::MAXIMIZE);
-    solve_impl();
+    solve(ObjectiveSense::MAXIMIZE);
 }
 
 } // namespace ilp_solver
@@ -2,6 +2,10 @@
 
 #include "ilp_solver_interface.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <optional>
 #include <string>
 #include <vector>
@@ -12,7 +16,6 @@ namespace ilp_solver
 
 using OptionalIndexArray = std::optional<IndexArray>;
 using OptionalValueArray = std::optional<ValueArray>;
-enum class VariableType   { INTEGER, CONTINUOUS, BINARY };
 enum class ObjectiveSense { MINIMIZE, MAXIMIZE };
 
 
@@ -69,15 +72,66 @@ public:
     void add_constraint_equality (                          ValueArray p_col_values,                                              double p_value,    const std::string& p_name = "") override final;
     void add_constraint_equality (IndexArray p_col_indices, ValueArray p_col_values,                                              double p_value,    const std::string& p_name = "") override final;
 
+    void add_variables           (ValueArray p_objectives, ValueArray p_lower_bounds, ValueArray p_upper_bounds, VariableTypeArray p_types,
+                                  IndexArray p_col_starts = {}, IndexArray p_row_indices = {}, ValueArray p_values = {}) override final;
+    void add_constraints         (ValueArray p_lower_bounds, ValueArray p_upper_bounds,
+                                  IndexArray p_row_starts, IndexArray p_col_indices, ValueArray p_values) override final;
+    void load_model              (const ILPDataView& p_model) override final;
+
     void minimize() override final;
     void maximize() override final;
 
     void set_max_seconds(double p_seconds) override final;
+
+    void set_stop_condition(std::function<bool()> p_stop_condition) override final;
+
+    void request_stop() override final;
+
+    void set_progress_handler(std::function<void(const SolverProgress&)> p_progress_handler) override final;
+
+    // Only stores the policy in d_interim_policy, which implementations apply by an InterimDelivery (see interim_delivery.hpp).
+    void set_interim_policy(const InterimPolicy& p_policy) override { d_interim_policy = p_policy; }
+
+    // Throws std::runtime_error. Overwrite it if the solver can set its parameters by name.
+    void set_solver_parameter(const std::string& p_name, const std::string& p_value) override;
 protected:
     ILPSolverImpl() = default;
     double d_max_seconds{}; // Stored separately because solver input may transform the seconds.
 
+    // Whether stop_requested returns true once d_max_seconds have passed since minimize() or maximize() were called.
+    // This enforces the time limit also in phases in which the solver does not check its own one.
+    bool d_enforce_max_seconds{true};
+
+    InterimPolicy d_interim_policy{};
+
+    // Evaluates request_stop, the time limit (see d_enforce_max_seconds) and the stop condition.
+    // Implementations call it from the interrupt mechanism of their solver.
+    bool stop_requested() const
+    {
+        return d_stop_request || std::chrono::steady_clock::now() >= d_deadline || (d_stop_condition && d_stop_condition());
+    }
+
+    // The seconds left of d_max_seconds in the current solve, for solvers whose own time limit counts from a later start.
+    // Without d_enforce_max_seconds, this is d_max_seconds.
+    double seconds_left() const
+    {
+        if (!d_enforce_max_seconds)
+            return d_max_seconds;
+        return std::max(0., std::chrono::duration<double>(d_deadline - std::chrono::steady_clock::now()).count());
+    }
+
+    // Passes progress to the progress handler. Implementations call it from the same places as stop_requested.
+    void report_progress(const SolverProgress& p_progress) const { if (d_progress_handler) d_progress_handler(p_progress); }
+
 private:
+    std::atomic<bool>                           d_stop_request{false};
+    std::chrono::steady_clock::time_point       d_deadline{std::chrono::steady_clock::time_point::max()};
+    std::function<bool()>                       d_stop_condition;
+    std::function<void(const SolverProgress&)> d_progress_handler;
+
+    // Common part of minimize and maximize.
+    void solve(ObjectiveSense p_sense);
+
     // If there is anything that needs to be done before a solve, overwrite prepare_impl.
     // It will be called before set_objective_sense_impl and solve_impl.
     // Useful e.g. for cached problems etc.
@@ -88,6 +142,19 @@ private:
                                    OptionalIndexArray p_row_indices = {})                                   = 0;
     virtual void add_constraint_impl(double p_lower_bound, double p_upper_bound, ValueArray p_col_values,
                                      const std::string& p_name = "", OptionalIndexArray p_col_indices = {}) = 0;
+    // Bulk versions of add_variable_impl and add_constraint_impl. Overwrite them if the solver has a native bulk loader.
+    // The arrays have already been checked for consistent sizes. p_col_starts is either empty or has one entry more
+    // than there are new variables. Constraints without finite bounds have already been removed.
+    // The default versions call add_variable_impl and add_constraint_impl for each variable and constraint.
+    virtual void add_variables_impl(ValueArray p_objectives, ValueArray p_lower_bounds, ValueArray p_upper_bounds,
+                                    VariableTypeArray p_types, IndexArray p_col_starts, IndexArray p_row_indices,
+                                    ValueArray p_values);
+    virtual void add_constraints_impl(ValueArray p_lower_bounds, ValueArray p_upper_bounds, IndexArray p_row_starts,
+                                      IndexArray p_col_indices, ValueArray p_values);
+    // Loads p_model into the empty solver. Overwrite it if the solver can take a whole model in one shot.
+    // p_model has already been checked like for add_variables and add_constraints, and has no constraints without finite bounds.
+    // The default version calls add_variables_impl and add_constraints_impl.
+    virtual void load_model_impl(const ILPDataView& p_model);
     virtual void solve_impl()                                                                               = 0;
     virtual void set_objective_sense_impl(ObjectiveSense p_sense)                                           = 0;
     virtual void set_max_seconds_impl(double p_seconds)                                                     = 0;
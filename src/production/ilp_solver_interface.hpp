@@ -3,6 +3,7 @@
 #include "solver_exit_code.hpp"
 
 #include <functional>
+#include <limits>
 #include <span>
 #include <stdexcept>
 #include <string>
@@ -11,13 +12,21 @@
 
 namespace ilp_solver
 {
-    using IndexArray = std::span<const int>;
-    using ValueArray = std::span<const double>;
+    enum class VariableType   { INTEGER, CONTINUOUS, BINARY };
 
+    using IndexArray        = std::span<const int>;
+    using ValueArray        = std::span<const double>;
+    using VariableTypeArray = std::span<const VariableType>;
+
+    struct ILPDataView;
     struct ILPSolutionData;
 
     enum class SolutionStatus {PROVEN_OPTIMAL, PROVEN_INFEASIBLE, PROVEN_UNBOUNDED, SUBOPTIMAL, NO_SOLUTION};
 
+    // The solvers that ILPSolverStub can ask ScaiIlpExe to use (see create_solver_stub_backend).
+    // DEFAULT is the one ScaiIlpExe has always used, the first in all_solvers after the stub.
+    enum class SolverBackend  {DEFAULT, CBC, HIGHS, SCIP, GUROBI};
+
 
     static constexpr int    c_default_num_threads   {1};
     static constexpr int    c_default_log_level     {0};
@@ -36,6 +45,26 @@ namespace ilp_solver
            constexpr double c_pos_inf               {std::numeric_limits<double>::max()};
            constexpr double c_neg_inf               {std::numeric_limits<double>::lowest()};
 
+    // Progress of a running solve, see ILPSolverInterface::set_progress_handler.
+    struct SolverProgress
+    {
+        long long num_nodes{0};          // Branch and bound nodes processed so far.
+        double    best_bound{c_neg_inf}; // Best bound on the objective value found so far. c_neg_inf if unknown.
+
+        bool operator==(const SolverProgress&) const = default;
+    };
+
+    // Decides which improving solutions are passed to the interim handler, see ILPSolverInterface::set_interim_policy.
+    // Passing each one can cost much solver time, e.g. if heuristics improve a large model many times in a row,
+    // and the stub writes each solution to shared memory. The default passes each improving solution at once.
+    struct InterimPolicy
+    {
+        double min_interval_seconds{0.};     // Between two solutions passed.
+        double min_relative_improvement{0.}; // Of the objective, relative to the last solution passed.
+        bool   coalesce{true};               // Whether a solution that comes too early is passed once the interval has passed,
+                                             // unless a better one replaces it. Otherwise, it is dropped.
+    };
+
 
     class SolverExeException : public std::runtime_error
     {
@@ -91,6 +120,32 @@ namespace ilp_solver
             virtual void add_constraint_equality(                          ValueArray p_col_values,                                              double p_value,    const std::string& p_name = "") = 0;  //      a*x = v
             virtual void add_constraint_equality(IndexArray p_col_indices, ValueArray p_col_values,                                              double p_value,    const std::string& p_name = "") = 0;  //      a*x = v
 
+
+            // Add several variables at once. This is much faster than adding them one by one for large models.
+            // Variable j gets the objective factor p_objectives[j], the bounds p_lower_bounds[j] and p_upper_bounds[j]
+            // and the type p_types[j]. Binary variables must have the bounds 0 and 1.
+            // The constraint factors are given in compressed sparse column (CSC) format:
+            //     variable j has the factor p_values[k] in the current constraint p_row_indices[k] for p_col_starts[j] <= k < p_col_starts[j+1].
+            //     p_col_starts has one entry more than there are new variables, starts with 0 and ends with the number of factors.
+            //     If the new variables do not participate in any current constraints, the three arrays may be empty.
+            virtual void add_variables          (ValueArray p_objectives, ValueArray p_lower_bounds, ValueArray p_upper_bounds, VariableTypeArray p_types,
+                                                 IndexArray p_col_starts = {}, IndexArray p_row_indices = {}, ValueArray p_values = {}) = 0;
+
+            // Add several constraints p_lower_bounds[i] <= a_i*x <= p_upper_bounds[i] at once.
+            // This is much faster than adding them one by one for large models.
+            // The rows a_i are given in compressed sparse row (CSR) format:
+            //     constraint i has the factor p_values[k] for the current variable p_col_indices[k] for p_row_starts[i] <= k < p_row_starts[i+1].
+            //     p_row_starts has one entry more than there are new constraints, starts with 0 and ends with the number of factors.
+            // As for add_constraint, constraints without finite bounds are skipped.
+            virtual void add_constraints        (ValueArray p_lower_bounds, ValueArray p_upper_bounds,
+                                                 IndexArray p_row_starts, IndexArray p_col_indices, ValueArray p_values) = 0;
+
+            // Add the variables and constraints of p_model (defined in ilp_data.hpp) as add_variables and add_constraints would.
+            // The column indices in p_model.matrix refer to the variables of p_model, which are added after the existing ones.
+            // If the solver is still empty, some solvers take the whole model in one shot, which is faster still.
+            // The parameters in p_model (time limit etc.) and the start solution are ignored.
+            virtual void load_model             (const ILPDataView& p_model) = 0;
+
             // Obtain the current number of [constraints | variables].
             virtual int                 get_num_constraints        () const = 0;
             virtual int                 get_num_variables          () const = 0;
@@ -111,6 +166,7 @@ namespace ilp_solver
             virtual double              get_external_cpu_time_sec  () const { return 0; };
 
             // Obtain external peak memory usage in megabytes, if an external process was used.
+            // A worker of a pool (see create_solver_stub_pooled) reports its peak over all ILPs it has solved so far.
             virtual double              get_external_peak_memory_mb() const { return 0; };
 
             // Obtain the external exit code of the solver.
@@ -188,6 +244,34 @@ namespace ilp_solver
             // ILPSolutionData. May be unsupported by some solvers.
             virtual void set_interim_results   (std::function<void(ILPSolutionData*)> p_interim_function) = 0;
 
+            // Decides which of the interim results are passed to the function given to set_interim_results.
+            // Solutions that are not passed are not copied either. The last solution is always available by get_solution.
+            // May be unsupported by some solvers, which then pass each improving solution.
+            virtual void set_interim_policy    (const InterimPolicy& p_policy)                            = 0;
+
+            // Instructs the solver to call p_stop_condition regularly while solving and to stop as soon as possible
+            // once it returns true, keeping the best solution found so far.
+            // p_stop_condition may be called from threads of the solver.
+            // May be unsupported by some solvers, and some phases (e.g. solving an LP) may not be interruptible.
+            virtual void set_stop_condition    (std::function<bool()> p_stop_condition)                   = 0;
+
+            // Asks the running minimize() or maximize() to stop as soon as possible, like a stop condition that returns true.
+            // The best solution found so far can be read afterwards. May be called from any thread.
+            // A stop requested while no solve runs applies to the next one. The request ends when minimize() or maximize() return.
+            virtual void request_stop          ()                                                         = 0;
+
+            // Instructs the solver to call p_progress_handler regularly while solving, e.g., after each node.
+            // p_progress_handler may be called from threads of the solver.
+            // May be unsupported by some solvers.
+            virtual void set_progress_handler  (std::function<void(const SolverProgress&)> p_progress_handler) = 0;
+
+            // Set a parameter of the underlying solver by its native name, e.g. "mip_heuristic_effort" for HiGHS
+            // or "separating/maxrounds" for SCIP. The value is converted from text to the type of the parameter.
+            // Throws std::runtime_error if the solver does not know the parameter or rejects the value,
+            // or if it does not support setting parameters by name.
+            // A stub passes the parameter on to its solver process, which throws there (see SolverExitCode::backend_error).
+            virtual void set_solver_parameter  (const std::string& p_name, const std::string& p_value) = 0;
+
             // Print a mps-formatted file of the current model.
             // p_path must be valid path to a file with write-permission.
             // Not const because some solvers may apply their caches, e.g. CoinModel.writeMps is not const.
@@ -6,9 +6,13 @@
 #pragma comment(lib, "libOsiClp.lib")
 
 #include "ilp_solver_osi_model.hpp"
+#include "ilp_data.hpp"
 #include "utility.hpp"
 
+#include <CoinPackedMatrix.hpp>
 #include <OsiSolverInterface.hpp>
+#include <type_traits>
+#include <vector>
 
 
 namespace ilp_solver
@@ -96,6 +100,73 @@ namespace ilp_solver
         }
         d_cache_changed = true;
     }
+
+
+    void ILPSolverOsiModel::add_variables_impl (ValueArray p_objectives, ValueArray p_lower_bounds, ValueArray p_upper_bounds,
+                                                VariableTypeArray p_types, IndexArray p_col_starts, IndexArray p_row_indices,
+                                                ValueArray p_values)
+    {
+        for (int j = 0; j < isize(p_objectives); ++j)
+        {
+            const auto begin = p_col_starts.empty() ? 0 : p_col_starts[j];
+            const auto size  = p_col_starts.empty() ? 0 : p_col_starts[j + 1] - begin;
+            // OSI has no special case for binary variables.
+            d_cache.addCol(size, p_row_indices.data() + begin, p_values.data() + begin, p_lower_bounds[j],
+                           p_upper_bounds[j], p_objectives[j], nullptr, p_types[j] != VariableType::CONTINUOUS);
+        }
+        d_cache_changed = true;
+    }
+
+
+    void ILPSolverOsiModel::add_constraints_impl (ValueArray p_lower_bounds, ValueArray p_upper_bounds, IndexArray p_row_starts,
+                                                  IndexArray p_col_indices, ValueArray p_values)
+    {
+        for (int i = 0; i < isize(p_lower_bounds); ++i)
+        {
+            const auto begin = p_row_starts[i];
+            d_cache.addRow(p_row_starts[i + 1] - begin, p_col_indices.data() + begin, p_values.data() + begin,
+                           p_lower_bounds[i], p_upper_bounds[i], nullptr);
+        }
+        d_cache_changed = true;
+    }
+
+
+    void ILPSolverOsiModel::load_model_impl (const ILPDataView& p_model)
+    {
+        const auto& matrix          = p_model.matrix;
+        const auto  num_variables   = isize(p_model.objective);
+        const auto  num_constraints = isize(p_model.constraint_lower);
+        if (num_constraints == 0)
+        {
+            ILPSolverImpl::load_model_impl(p_model);
+            return;
+        }
+
+        // CoinBigIndex may be wider than int, depending on how CoinUtils has been built.
+        std::vector<CoinBigIndex> row_starts;
+        const CoinBigIndex*       row_starts_ptr;
+        if constexpr (std::is_same_v<CoinBigIndex, int>)
+            row_starts_ptr = matrix.d_row_starts.data();
+        else
+        {
+            row_starts.assign(matrix.d_row_starts.begin(), matrix.d_row_starts.end());
+            row_starts_ptr = row_starts.data();
+        }
+
+        // CoinModel stores the matrix by columns.
+        CoinPackedMatrix packed_matrix(false, num_variables, num_constraints, isize(matrix.d_values),
+                                       matrix.d_values.data(), matrix.d_indices.data(), row_starts_ptr, nullptr);
+        packed_matrix.reverseOrdering();
+
+        d_cache = CoinModel(num_constraints, num_variables, &packed_matrix,
+                            p_model.constraint_lower.data(), p_model.constraint_upper.data(),
+                            p_model.variable_lower.data(), p_model.variable_upper.data(), p_model.objective.data());
+        // OSI has no special case for binary variables.
+        for (int j = 0; j < num_variables; ++j)
+            if (p_model.variable_type[j] != VariableType::CONTINUOUS)
+                d_cache.setInteger(j);
+        d_cache_changed = true;
+    }
 }
 
 #endif
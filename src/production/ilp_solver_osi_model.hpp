@@ -45,6 +45,18 @@ namespace ilp_solver
                                       ValueArray p_col_values, [[maybe_unused]] const std::string& p_name = "",
                                       OptionalIndexArray p_col_indices = {}) override;
 
+            // CoinModel has no bulk append, but adding the columns and rows directly from the given arrays
+            // avoids the per-call overhead. The whole cache is loaded into the solver at once in prepare_impl.
+            void add_variables_impl (ValueArray p_objectives, ValueArray p_lower_bounds, ValueArray p_upper_bounds,
+                                     VariableTypeArray p_types, IndexArray p_col_starts, IndexArray p_row_indices,
+                                     ValueArray p_values) override;
+
+            void add_constraints_impl (ValueArray p_lower_bounds, ValueArray p_upper_bounds, IndexArray p_row_starts,
+                                       IndexArray p_col_indices, ValueArray p_values) override;
+
+            // Builds the cache from one packed matrix instead of adding the rows one by one.
+            void load_model_impl (const ILPDataView& p_model) override;
+
             // Helper object for dense -> sparse conversions.
             SparseVec d_sparse{};
     };
@@ -0,0 +1,125 @@
+#include "ilp_solver_portfolio.hpp"
+
+#include "ilp_solver_factory.hpp"
+#include "portfolio_race.hpp"
+#include "utility.hpp"
+
+#include <cassert>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ilp_solver
+{
+
+// set_default_parameters is called in ILPSolverCollect.
+ILPSolverPortfolio::ILPSolverPortfolio(std::vector<PortfolioRacer> p_racers) : d_racers(std::move(p_racers))
+{
+    assert(!d_racers.empty());
+}
+
+
+void ILPSolverPortfolio::reset_solution()
+{
+    d_ilp_data.start_solution.clear();
+    d_ilp_solution_data = ILPSolutionData(d_ilp_data.objective_sense);
+}
+
+
+void ILPSolverPortfolio::set_interim_results(std::function<void(ILPSolutionData*)> p_interim_handler)
+{
+    d_interim_handler = std::move(p_interim_handler);
+}
+
+
+ILPSolutionData ILPSolverPortfolio::run_racer(const PortfolioRacer& p_racer, const ILPDataView& p_model, PortfolioRace* v_race) const
+{
+    auto solver = create_solver(p_racer.backend);
+    if (!solver)
+        throw std::runtime_error("Solver of portfolio racer not available.");
+
+    // As ScaiIlpExe does with the model of the stub.
+    solver->load_model(p_model);
+    if (!p_model.start_solution.empty())
+        solver->set_start_solution(p_model.start_solution);
+
+    solver->set_num_threads       (p_model.num_threads);
+    solver->set_deterministic_mode(p_model.deterministic);
+    solver->set_log_level         (p_model.log_level);
+    solver->set_presolve          (p_model.presolve);
+
+    solver->set_max_seconds       (p_model.max_seconds);
+    solver->set_max_nodes         (p_model.max_nodes);
+    solver->set_max_solutions     (p_model.max_solutions);
+    solver->set_max_abs_gap       (p_model.max_abs_gap);
+    solver->set_max_rel_gap       (p_model.max_rel_gap);
+    solver->set_cutoff            (p_model.cutoff);
+
+    solver->set_interim_policy    (p_model.interim_policy);
+
+    for_each_solver_parameter(p_model.solver_parameters, [&solver](const std::string& p_name, const std::string& p_value)
+                              { solver->set_solver_parameter(p_name, p_value); });
+    for (const auto& [name, value] : p_racer.solver_parameters)
+        solver->set_solver_parameter(name, value);
+
+    solver->set_stop_condition([this, v_race]()
+    {
+        if (v_race->is_decided())
+            return true;
+        std::lock_guard lock(v_race->mutex());
+        return stop_requested();
+    });
+    solver->set_progress_handler([this, v_race](const SolverProgress& p_progress)
+    {
+        std::lock_guard lock(v_race->mutex());
+        report_progress(p_progress);
+    });
+    if (d_interim_handler)
+        solver->set_interim_results([v_race](ILPSolutionData* p_solution) { v_race->offer_interim(p_solution); });
+
+    if (p_model.objective_sense == ObjectiveSense::MINIMIZE)
+        solver->minimize();
+    else
+        solver->maximize();
+
+    ILPSolutionData solution;
+    solution.solution        = solver->get_solution();
+    solution.dual_sol        = solver->get_dual_sol();
+    solution.objective       = solver->get_objective();
+    solution.solution_status = solver->get_status();
+    return solution;
+}
+
+
+void ILPSolverPortfolio::solve_impl()
+{
+    d_ilp_solution_data = ILPSolutionData(d_ilp_data.objective_sense);
+
+    const auto    num_racers = isize(d_racers);
+    const auto    model      = make_view(d_ilp_data);
+    PortfolioRace race(num_racers, d_ilp_data.objective_sense, d_interim_handler);
+
+    auto run = [this, &model, &race](int p_index)
+    {
+        try         { race.finish(p_index, run_racer(d_racers[p_index], model, &race)); }
+        catch (...) { race.fail(p_index, std::current_exception()); }
+    };
+    {
+        // The first racer runs in this thread.
+        std::vector<std::jthread> threads;
+        for (auto i = 1; i < num_racers; ++i)
+            threads.emplace_back(run, i);
+        run(0);
+    }
+
+    const auto selected = race.select_racer();
+    if (d_ilp_data.log_level)
+        std::cout << "Portfolio: Solution of racer " << selected << (race.winner() >= 0 ? " (winner)\n" : "\n");
+    d_ilp_solution_data = race.take_solution(selected);
+}
+
+} // namespace ilp_solver
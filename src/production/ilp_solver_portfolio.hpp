@@ -0,0 +1,50 @@
+#pragma once
+
+#include "ilp_data.hpp"
+#include "ilp_solver_collect.hpp"
+#include "portfolio_racer.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ilp_solver
+{
+    class PortfolioRace;
+
+    // Collects the ILP like the stub, but solves it in this process: one solver per racer, each in its own thread.
+    // Use it instead of create_solver_stub_portfolio if you can not afford a process per racer, but have spare cores.
+    // Unlike with the stub, a crash of any racer takes down the whole process.
+    class ILPSolverPortfolio final : public ILPSolverCollect
+    {
+        public:
+            // p_racers must not be empty. Each racer gets a new solver of its backend for each ILP.
+            explicit ILPSolverPortfolio(std::vector<PortfolioRacer> p_racers);
+
+            std::vector<double> get_solution()  const override { return d_ilp_solution_data.solution; };
+            std::vector<double> get_dual_sol()  const override { return d_ilp_solution_data.dual_sol; };
+            double              get_objective() const override { return d_ilp_solution_data.objective; };
+            SolutionStatus      get_status()    const override { return d_ilp_solution_data.solution_status; };
+
+            void reset_solution() override;
+
+            // Each solution of any racer that improves on all solutions passed before is passed to p_interim_handler.
+            // It is called from the threads of the racers, but never concurrently with itself.
+            void set_interim_results(std::function<void(ILPSolutionData*)> p_interim_handler) override;
+
+        private:
+            const std::vector<PortfolioRacer> d_racers;
+            ILPSolutionData                   d_ilp_solution_data;
+
+            std::function<void(ILPSolutionData*)> d_interim_handler;
+
+            // Replays d_ilp_data into the solver of each racer, and solves with all of them at the same time
+            // by the rules of PortfolioRace. The racers that should stop are stopped by their stop condition.
+            // If a racer throws, e.g. because its backend is not available or rejects a parameter, the exception is rethrown
+            // after all racers have returned, unless another racer has a solution.
+            void solve_impl() override;
+
+            // Creates the solver of p_racer, solves the ILP with it, and returns its solution.
+            ILPSolutionData run_racer(const PortfolioRacer& p_racer, const ILPDataView& p_model, PortfolioRace* v_race) const;
+    };
+}
@@ -5,7 +5,11 @@
 
 #include <algorithm>
 #include <cassert>
+#include <charconv>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 namespace ilp_solver
 {
@@ -55,14 +59,80 @@ namespace ilp_solver
             auto deleter = [v_scip](SCIP_SOL* v_sol) { SCIPfreeSol(v_scip, &v_sol); };
             return std::unique_ptr<SCIP_SOL, decltype(deleter)>(sol, deleter);
         }
+
+
+        template<typename T>
+        T parse_parameter_value(const std::string& p_name, const std::string& p_value)
+        {
+            T          value{};
+            const auto end    = p_value.data() + p_value.size();
+            const auto result = std::from_chars(p_value.data(), end, value);
+            if (result.ec != std::errc() || result.ptr != end)
+                throw std::runtime_error("SCIP parameter " + p_name + " can not be set to \"" + p_value + "\".");
+            return value;
+        }
     } // namespace
 
 
+    // Callbacks of the event handler of ILPSolverSCIP. Its data is the ILPSolverSCIP.
+    struct ILPSolverSCIP::EventHandler
+    {
+        // Events at which progress is reported and the stop condition is checked.
+        static constexpr SCIP_EVENTTYPE c_stop_check_events = SCIP_EVENTTYPE_PRESOLVEROUND | SCIP_EVENTTYPE_LPSOLVED
+                                                            | SCIP_EVENTTYPE_NODESOLVED;
+        static constexpr SCIP_EVENTTYPE c_events            = c_stop_check_events | SCIP_EVENTTYPE_BESTSOLFOUND;
+
+        // Global events can only be caught once the problem has been transformed.
+        static SCIP_DECL_EVENTINIT(init)
+        {
+            return SCIPcatchEvent(scip, c_events, eventhdlr, nullptr, nullptr);
+        }
+
+        static SCIP_DECL_EVENTEXIT(exit)
+        {
+            return SCIPdropEvent(scip, c_events, eventhdlr, nullptr, -1);
+        }
+
+        // Offers the solution to d_interim, which fills the values of the original variables into its buffer if it takes it.
+        static SCIP_RETCODE offer_interim_solution(SCIP* p_scip, ILPSolverSCIP* v_solver, SCIP_SOL* p_sol)
+        {
+            // If SCIP cannot give the values, the solution is not passed, and the error is returned.
+            auto retcode = SCIP_OKAY;
+            v_solver->d_interim.offer(SCIPgetSolOrigObj(p_scip, p_sol), [p_scip, v_solver, p_sol, &retcode](double* r_values)
+            {
+                retcode = SCIPgetSolVals(p_scip, p_sol, isize(v_solver->d_cols), v_solver->d_cols.data(), r_values);
+                return retcode == SCIP_OKAY;
+            });
+            return retcode;
+        }
+
+        static SCIP_DECL_EVENTEXEC(exec)
+        {
+            const auto solver = reinterpret_cast<ILPSolverSCIP*>(SCIPeventhdlrGetData(eventhdlr));
+            if (SCIPeventGetType(event) == SCIP_EVENTTYPE_BESTSOLFOUND)
+                return solver->d_interim.has_handler() ? offer_interim_solution(scip, solver, SCIPeventGetSol(event)) : SCIP_OKAY;
+
+            solver->d_interim.poll();
+            if (SCIPgetStage(scip) == SCIP_STAGE_SOLVING)
+                solver->report_progress({SCIPgetNNodes(scip), SCIPgetDualbound(scip)});
+            if (solver->stop_requested())
+                return SCIPinterruptSolve(scip);
+            return SCIP_OKAY;
+        }
+    };
+
+
     ILPSolverSCIP::ILPSolverSCIP()
     {
         call_scip(SCIPcreate, &d_scip);
         call_scip(SCIPincludeDefaultPlugins, d_scip);
 
+        SCIP_EVENTHDLR* event_handler;
+        call_scip(SCIPincludeEventhdlrBasic, d_scip, &event_handler, "scaiilp", "ScaiIlp progress, stop condition and interim results",
+                  EventHandler::exec, reinterpret_cast<SCIP_EVENTHDLRDATA*>(this));
+        call_scip(SCIPsetEventhdlrInit, d_scip, event_handler, EventHandler::init);
+        call_scip(SCIPsetEventhdlrExit, d_scip, event_handler, EventHandler::exit);
+
         // All the nullptr's are possible User-data.
         call_scip(SCIPcreateProb, d_scip, "problem", nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
         call_scip(SCIPsetObjsense, d_scip, SCIP_OBJSENSE_MINIMIZE); // Needs a start objective sense.
@@ -314,6 +384,41 @@ namespace ilp_solver
     }
 
 
+    void ILPSolverSCIP::set_solver_parameter(const std::string& p_name, const std::string& p_value)
+    {
+        const auto param = SCIPgetParam(d_scip, p_name.c_str());
+        if (param == nullptr)
+            throw std::runtime_error("SCIP could not find a parameter of the name " + p_name + ".");
+
+        const auto name = p_name.c_str();
+        switch (SCIPparamGetType(param))
+        {
+            case SCIP_PARAMTYPE_BOOL:
+                if (p_value != "TRUE" && p_value != "FALSE")
+                    throw std::runtime_error("SCIP parameter " + p_name + " can not be set to \"" + p_value + "\".");
+                call_scip(SCIPsetBoolParam, d_scip, name, p_value == "TRUE" ? TRUE : FALSE);
+                break;
+            case SCIP_PARAMTYPE_INT:
+                call_scip(SCIPsetIntParam, d_scip, name, parse_parameter_value<int>(p_name, p_value));
+                break;
+            case SCIP_PARAMTYPE_LONGINT:
+                call_scip(SCIPsetLongintParam, d_scip, name, parse_parameter_value<SCIP_Longint>(p_name, p_value));
+                break;
+            case SCIP_PARAMTYPE_REAL:
+                call_scip(SCIPsetRealParam, d_scip, name, parse_parameter_value<SCIP_Real>(p_name, p_value));
+                break;
+            case SCIP_PARAMTYPE_CHAR:
+                if (p_value.size() != 1)
+                    throw std::runtime_error("SCIP parameter " + p_name + " can not be set to \"" + p_value + "\".");
+                call_scip(SCIPsetCharParam, d_scip, name, p_value[0]);
+                break;
+            case SCIP_PARAMTYPE_STRING:
+                call_scip(SCIPsetStringParam, d_scip, name, p_value.c_str());
+                break;
+        }
+    }
+
+
     void ILPSolverSCIP::print_mps_file(const std::string& p_path)
     {
         // uses the extension of p_path, so this has to be ".mps".
@@ -329,9 +434,19 @@ namespace ilp_solver
     }
 
 
+    void ILPSolverSCIP::set_interim_results(std::function<void(ILPSolutionData*)> p_interim_handler)
+    {
+        d_interim.set_handler(std::move(p_interim_handler));
+    }
+
+
     void ILPSolverSCIP::solve_impl()
     {
+        d_interim.start(d_interim_policy, SCIPgetObjsense(d_scip) == SCIP_OBJSENSE_MAXIMIZE ? ObjectiveSense::MAXIMIZE
+                                                                                           : ObjectiveSense::MINIMIZE,
+                        isize(d_cols));
         call_scip(SCIPsolve, d_scip);
+        d_interim.finish();
     }
 
 
@@ -428,6 +543,65 @@ namespace ilp_solver
         call_scip(SCIPaddCons, d_scip, cons);
         d_rows.push_back(cons);
     }
+
+
+    void ILPSolverSCIP::add_variables_impl(ValueArray p_objectives, ValueArray p_lower_bounds, ValueArray p_upper_bounds,
+        VariableTypeArray p_types, IndexArray p_col_starts, IndexArray p_row_indices, ValueArray p_values)
+    {
+        const auto num_variables = isize(p_objectives);
+        d_cols.reserve(d_cols.size() + num_variables);
+
+        for (int j = 0; j < num_variables; ++j)
+        {
+            SCIP_VAR*    var;
+            SCIP_VARTYPE type = (p_types[j] == VariableType::INTEGER)    ? SCIP_VARTYPE_INTEGER
+                              : (p_types[j] == VariableType::CONTINUOUS) ? SCIP_VARTYPE_CONTINUOUS : SCIP_VARTYPE_BINARY;
+            // Same flags as in add_variable_impl.
+            call_scip(SCIPcreateVar, d_scip, &var, "", p_lower_bounds[j], p_upper_bounds[j], p_objectives[j], type, TRUE,
+                      FALSE, nullptr, nullptr, nullptr, nullptr, nullptr);
+            call_scip(SCIPaddVar, d_scip, var);
+            d_cols.push_back(var);
+
+            if (p_col_starts.empty())
+                continue;
+
+            // SCIP can only add coefficients to existing linear constraints one by one.
+            for (int k = p_col_starts[j]; k < p_col_starts[j + 1]; ++k)
+            {
+                assert(p_row_indices[k] < isize(d_rows));
+                call_scip(SCIPaddCoefLinear, d_scip, d_rows[p_row_indices[k]], var, p_values[k]);
+            }
+        }
+    }
+
+
+    void ILPSolverSCIP::add_constraints_impl(ValueArray p_lower_bounds, ValueArray p_upper_bounds, IndexArray p_row_starts,
+        IndexArray p_col_indices, ValueArray p_values)
+    {
+        const auto num_constraints = isize(p_lower_bounds);
+        d_rows.reserve(d_rows.size() + num_constraints);
+
+        // One buffer for the variables of all constraints. SCIP copies it on creating the constraint.
+        std::vector<SCIP_VAR*> vars(p_col_indices.size());
+        std::ranges::transform(p_col_indices, vars.begin(), [this](int p_index)
+        {
+            assert(p_index < get_num_variables());
+            return d_cols[p_index];
+        });
+
+        for (int i = 0; i < num_constraints; ++i)
+        {
+            const auto begin = p_row_starts[i];
+            const auto size  = p_row_starts[i + 1] - begin;
+
+            // See add_constraint_impl for the const_cast and the flags.
+            SCIP_CONS* cons;
+            call_scip(SCIPcreateConsLinear, d_scip, &cons, "", size, vars.data() + begin, const_cast<double*>(p_values.data()) + begin,
+                      p_lower_bounds[i], p_upper_bounds[i], TRUE, TRUE, TRUE, TRUE, TRUE, FALSE, FALSE, FALSE, FALSE, FALSE);
+            call_scip(SCIPaddCons, d_scip, cons);
+            d_rows.push_back(cons);
+        }
+    }
 }
 
 #endif
@@ -3,6 +3,10 @@
 #ifdef WITH_SCIP
 
 #include "ilp_solver_impl.hpp"
+#include "interim_delivery.hpp"
+
+#include <functional>
+#include <vector>
 
 namespace ilp_solver
 {
@@ -47,13 +51,23 @@ namespace ilp_solver
         void set_max_rel_gap       (double p_gap)                          override;
         void set_cutoff            (double p_cutoff)                       override;
 
+        // Any parameter of SCIP, e.g. "separating/maxrounds". Bools are given as "TRUE" or "FALSE".
+        void set_solver_parameter  (const std::string& p_name, const std::string& p_value) override;
+
         void print_mps_file        (const std::string& p_path)             override;
 
-        void set_interim_results   (std::function<void(ILPSolutionData*)>) override{ /* Not yet implemented*/ }
+        // Like the event handler of CBC, solutions that improve on the last one are passed to p_interim_handler
+        // as the interim policy says.
+        void set_interim_results   (std::function<void(ILPSolutionData*)> p_interim_handler) override;
 
     private:
+        // Checks the stop condition and passes interim solutions during the solve.
+        struct EventHandler;
+
         SCIP* d_scip;
 
+        InterimDelivery           d_interim;
+
         std::vector<SCIP_CONS*>   d_rows;
         std::vector<SCIP_VAR*>    d_cols;
 
@@ -68,6 +82,13 @@ namespace ilp_solver
                                   ValueArray p_col_values, const std::string& p_name = "",
                                   OptionalIndexArray p_col_indices = {}) override;
 
+        void add_variables_impl  (ValueArray p_objectives, ValueArray p_lower_bounds, ValueArray p_upper_bounds,
+                                  VariableTypeArray p_types, IndexArray p_col_starts, IndexArray p_row_indices,
+                                  ValueArray p_values) override;
+
+        void add_constraints_impl(ValueArray p_lower_bounds, ValueArray p_upper_bounds, IndexArray p_row_starts,
+                                  IndexArray p_col_indices, ValueArray p_values) override;
+
         void set_max_seconds_impl(double p_seconds) override;
     };
 }
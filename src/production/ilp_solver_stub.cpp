@@ -3,49 +3,59 @@
 #include "ilp_solver_stub.hpp"
 
 #include "ilp_solver_interface.hpp"
+#include "portfolio_race.hpp"
+#include "shared_memory_arena.hpp"
 #include "shared_memory_communication.hpp"
 #include "solver_exit_code.hpp"
 #include "tester.hpp"
+#include "utility.hpp"
+#include "watchdog.hpp"
+#include "worker_pool.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <exception>
 #include <format>
+#include <functional>
 #include <iostream>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <boost/dll/runtime_symbol_info.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/process.hpp>
 
 namespace ilp_solver
 {
 // In AXS-1452, we introduced a wait time limit because we observed CBC not terminating after hours
 // despite a given time limit of minutes.
-// We now wait for (max_seconds plus some overtime) =: wait_max_seconds.
-// When wait_max_seconds is exceeded, the external process is killed, but the intermediate result reached is preserved.
+// When the external process is killed, the intermediate result reached is preserved.
 // This is more convenient than letting the user kill the external process or even the calling process.
 // (The latter would lose the intermediate result).
 //
-// In AXS-1452, we started with relative_overtime=0.5.
-// We hoped that this would be large enough to always terminate regularly.
-// Also we had recommended one of our users to kill the process after 2*max_seconds,
-// so we wanted a smaller wait_max_seconds.
-//
-// After AXS-2636 we observed that occasionally CBC still ran into wait_max_seconds. So we added absolute_overtime.
-// Unlike the initial instance from AXS-1452, the runtime of the instance of AXS-2636 seems very volatile.
-// With time_limit=20s (60s distributed to 3 calls), overtime ranges from <2s total to >10s for on one run.
-//
-// Current values are experimental.
-constexpr auto c_relative_overtime         = 0.5;
-constexpr auto c_absolute_overtime_seconds = 10.0;
+// Fixed overtimes (0.5*max_seconds after AXS-1452, plus 10s after AXS-2636) either wasted time or killed
+// healthy solves, as the overtime of CBC turned out to be very volatile.
+// Now the process is asked to stop after max_seconds, and the Watchdog decides when to kill it
+// based on the heartbeats and the progress it reports (see WatchdogPolicy).
+
+// How often the thread delivering interim results checks whether it should stop.
+constexpr auto c_interim_stop_check_interval = std::chrono::milliseconds(100);
 
 
-static std::chrono::milliseconds seconds_to_millisecods(double p_seconds)
+// We expect the ScaiILP executable lying next to the one calling it.
+// Outside of Windows, a missing ".exe" extension is tolerated, such that the same base name can be used on all platforms.
+static boost::filesystem::path executable_path(const std::string& p_executable_basename)
 {
-    const auto     milliseconds     = 1000. * p_seconds;
-    constexpr auto max_milliseconds = std::numeric_limits<std::chrono::milliseconds::rep>::max();
-    if (milliseconds >= static_cast<double>(max_milliseconds))
-        return std::chrono::milliseconds(max_milliseconds);
-    return std::chrono::milliseconds(static_cast<std::chrono::milliseconds::rep>(milliseconds));
+    auto path = boost::dll::program_location().parent_path() / p_executable_basename;
+#ifndef _WIN32
+    if (path.extension() == ".exe" && !boost::filesystem::exists(path))
+        path.replace_extension();
+#endif
+    return path;
 }
 
 
@@ -87,6 +97,8 @@ static std::string exit_code_to_message(SolverExitCode p_exit_code)
         return "Invalid start solution.";
     case SolverExitCode::stub_tester_failed:
         return "stub_tester failed.";
+    case SolverExitCode::backend_error:
+        return "Requested solver not available or solver parameter rejected.";
     default:
         return "Unknown exit code " + std::to_string(static_cast<int>(p_exit_code)) + ".";
     }
@@ -112,9 +124,142 @@ static bool exit_code_should_be_ignored_silently(SolverExitCode p_exit_code)
 
 
 // set_default_parameters is called in ILPSolverCollect.
-ILPSolverStub::ILPSolverStub(const std::string& p_executable_basename, bool p_throw_on_all_crashes)
-    : d_executable_basename(p_executable_basename), d_throw_on_all_crashes(p_throw_on_all_crashes)
-{ }
+// The model is collected in shared memory, such that large arrays need not be copied for the solver process.
+ILPSolverStub::ILPSolverStub(const std::string& p_executable_basename, bool p_throw_on_all_crashes, int p_num_workers,
+                             const WatchdogPolicy& p_watchdog_policy, bool p_prelaunch, SolverBackend p_backend,
+                             std::vector<PortfolioRacer> p_racers)
+    : ILPSolverCollect(std::make_unique<SharedMemoryArena>()),
+      d_executable_basename(p_executable_basename), d_throw_on_all_crashes(p_throw_on_all_crashes),
+      d_num_workers(p_num_workers), d_watchdog_policy(p_watchdog_policy), d_prelaunch(p_prelaunch),
+      d_racers(std::move(p_racers))
+{
+    d_ilp_data.backend = p_backend;
+    if (!d_prelaunch)
+        return;
+    if (d_num_workers == 0)
+        d_own_pool = std::make_unique<WorkerPool>(executable_path(d_executable_basename), std::max(1, isize(d_racers)));
+    worker_pool().prelaunch();
+}
+
+
+// Shuts down the prelaunched process, if any.
+ILPSolverStub::~ILPSolverStub() = default;
+
+
+WorkerPool& ILPSolverStub::worker_pool() const
+{
+    return d_own_pool ? *d_own_pool : WorkerPool::instance(executable_path(d_executable_basename), d_num_workers);
+}
+
+
+SolverExitCode ILPSolverStub::run_process(const boost::filesystem::path& p_executable_path,
+                                          const std::string& p_shared_memory_name, Watchdog* v_watchdog) const
+{
+    // Start the process. If the log level is zero, suppress all of its output.
+    // Ideally, suppressing the output should not be necessary,
+    // but we have repeatedly observed CBC writing to stdout at log level zero.
+    auto proc = d_ilp_data.log_level != 0 ? boost::process::child(p_executable_path, p_shared_memory_name)
+                                          : boost::process::child(p_executable_path, p_shared_memory_name,
+                                                                  boost::process::std_out > boost::process::null,
+                                                                  boost::process::std_err > boost::process::null);
+    v_watchdog->start();
+    // Poll instead of using boost::child::wait_for, which is deprecated.
+    // On posix based systems, wait_for temporarily replaces the SIGCHLD handler,
+    // which crashes when several threads wait concurrently, as the racers of a portfolio do.
+    // See https://www.boost.org/doc/libs/1_83_0/doc/html/boost_process/v2.html#boost_process.v2.introduction.unreliable
+    while (proc.running())
+    {
+        if (v_watchdog->check())
+        {
+            proc.terminate(); // boost::process seems not to support to set the exit code by terminate().
+                              // Note that terminate(error_code&) does not set the exit code either, but has a different purpose.
+            return SolverExitCode::forced_termination; // Don't read the exit code, but set it manually to the fixed desired value.
+        }
+        std::this_thread::sleep_for(c_watchdog_check_interval);
+    }
+    return from_process_exit_code(proc.exit_code());
+}
+
+
+void ILPSolverStub::set_interim_results(std::function<void(ILPSolutionData*)> p_interim_handler)
+{
+    d_interim_handler = std::move(p_interim_handler);
+}
+
+
+namespace
+{
+// The process of one racer and what it has left.
+struct Racer
+{
+    CommunicationParent       communicator;
+    std::string               shared_memory_name;
+    std::unique_ptr<Watchdog> watchdog;
+    SolverExitCode            exit_code{SolverExitCode::ok};
+};
+} // namespace
+
+
+// After stop is requested, a solution written in the meantime is still delivered.
+void ILPSolverStub::deliver_interim_results(CommunicationParent* v_communicator, PortfolioRace* v_race, std::stop_token p_stop)
+{
+    while (true)
+    {
+        const auto stopping = p_stop.stop_requested();
+        if (v_communicator->wait_for_solution_data(stopping ? std::chrono::milliseconds(0) : c_interim_stop_check_interval))
+        {
+            ILPSolutionData solution;
+            v_communicator->read_solution_data(&solution);
+            v_race->offer_interim(&solution);
+        }
+        if (stopping)
+            return;
+    }
+}
+
+
+std::string ILPSolverStub::write_ilp_data(CommunicationParent* v_communicator, const PortfolioRacer* p_racer)
+{
+    if (p_racer == nullptr)
+        return v_communicator->write_ilp_data(d_ilp_data);
+
+    // The racer's parameters are appended temporarily, such that the large arrays are written only once, to the arena.
+    const auto backend              = d_ilp_data.backend;
+    const auto num_parameters_chars = d_ilp_data.solver_parameters.size();
+    auto       restore              = [this, backend, num_parameters_chars]()
+    {
+        d_ilp_data.backend = backend;
+        d_ilp_data.solver_parameters.resize(num_parameters_chars);
+    };
+
+    try
+    {
+        d_ilp_data.backend = p_racer->backend;
+        for (const auto& [name, value] : p_racer->solver_parameters)
+            d_ilp_data.add_solver_parameter(name, value);
+        auto shared_memory_name = v_communicator->write_ilp_data(d_ilp_data);
+        restore();
+        return shared_memory_name;
+    }
+    catch (...)
+    {
+        restore();
+        throw;
+    }
+}
+
+
+SolverExitCode ILPSolverStub::run_solver(const std::string& p_shared_memory_name, Watchdog* v_watchdog)
+{
+    if (d_num_workers == 0 && !d_own_pool)
+        return run_process(executable_path(d_executable_basename), p_shared_memory_name, v_watchdog);
+
+    auto&      pool      = worker_pool();
+    const auto exit_code = pool.solve(p_shared_memory_name, v_watchdog);
+    if (d_prelaunch)
+        pool.prelaunch();   // In case the worker has crashed.
+    return exit_code;
+}
 
 
 void ILPSolverStub::reset_solution()
@@ -132,44 +277,79 @@ void ILPSolverStub::solve_impl()
     {
         d_ilp_solution_data = ILPSolutionData(d_ilp_data.objective_sense);
 
-        CommunicationParent communicator;
-        const auto          shared_memory_name = communicator.write_ilp_data(d_ilp_data);
-        // We expect the ScaiILP executable lying next to the one calling it.
-        const auto full_executable_path = boost::dll::program_location().parent_path() / d_executable_basename;
-        // Start the process. If the log level is zero, suppress all of its output.
-        // Ideally, suppressing the output should not be necessary,
-        // but we have repeatedly observed CBC writing to stdout at log level zero.
-        auto proc = d_ilp_data.log_level != 0 ? boost::process::child(full_executable_path, shared_memory_name)
-                                              : boost::process::child(full_executable_path, shared_memory_name,
-                                                                      boost::process::std_out > boost::process::null,
-                                                                      boost::process::std_err > boost::process::null);
-        // Wait hopefully long enough. Kill child if time limit is exceeded. See comment on c_timeout_factor.
-        const auto wait_max_seconds = (1.0 + c_relative_overtime) * d_ilp_data.max_seconds + c_absolute_overtime_seconds;
-// boost::child::wait_for/wait_until have been deprecated, because they may be unreliable.
-// However, it seems that they are only problematic on posix based systems and not on windows.
-// See https://www.boost.org/doc/libs/1_83_0/doc/html/boost_process/v2.html#boost_process.v2.introduction.unreliable
-// So we just ignore the deprecation warning.
-#pragma warning(disable : 4996)
-        if (!proc.wait_for(seconds_to_millisecods(wait_max_seconds)))
-#pragma warning(default : 4996)
+        // Without a portfolio, the stub races alone, with its own backend and parameters.
+        const auto         num_racers = std::max(1, isize(d_racers));
+        std::vector<Racer> racers(num_racers);
+        PortfolioRace      race(num_racers, d_ilp_data.objective_sense, d_interim_handler);
+        for (auto i = 0; i < num_racers; ++i)
         {
-            proc.terminate(); // boost::process seems not to support to set the exit code by terminate().
-                              // Note that terminate(error_code&) does not set the exit code either, but has a different purpose.
-            d_exit_code = SolverExitCode::forced_termination; // Don't read the exit code, but set it manually to the fixed desired value.
-            exit_message = std::format("Failed solving by timeout. (limit:{} timeout:{})", d_ilp_data.max_seconds,
-                                       wait_max_seconds);
+            auto& racer              = racers[i];
+            racer.shared_memory_name = write_ilp_data(&racer.communicator, d_racers.empty() ? nullptr : &d_racers[i]);
+            racer.watchdog           = std::make_unique<Watchdog>(d_watchdog_policy, d_ilp_data.max_seconds, &racer.communicator,
+                                                                  [this, &race](const SolverProgress* p_progress)
+                                                                  {
+                                                                      std::lock_guard lock(race.mutex());
+                                                                      if (p_progress != nullptr)
+                                                                          report_progress(*p_progress);
+                                                                      return stop_requested() || race.is_decided();
+                                                                  });
         }
-        else
+
         {
-            d_exit_code = SolverExitCode(proc.exit_code());
-            exit_message = exit_code_to_message(d_exit_code);
+            std::vector<std::jthread> interim_threads;
+            if (d_interim_handler)
+            {
+                for (auto& racer : racers)
+                {
+                    interim_threads.emplace_back([&racer, &race](std::stop_token p_stop)
+                                                 { deliver_interim_results(&racer.communicator, &race, p_stop); });
+                }
+            }
+
+            // The first racer runs in this thread, such that a single one needs no thread of its own.
+            // The process has ended when run_solver returns, so its last solution is final.
+            auto run_racer = [this, &race](Racer& v_racer, int p_index)
+            {
+                try
+                {
+                    v_racer.exit_code = run_solver(v_racer.shared_memory_name, v_racer.watchdog.get());
+                    ILPSolutionData solution;
+                    v_racer.communicator.peek_solution_data(&solution);
+                    race.finish(p_index, std::move(solution), v_racer.exit_code != SolverExitCode::ok);
+                }
+                catch (...) { race.fail(p_index, std::current_exception()); }
+            };
+            {
+                std::vector<std::jthread> racer_threads;
+                for (auto i = 1; i < num_racers; ++i)
+                    racer_threads.emplace_back(run_racer, std::ref(racers[i]), i);
+                run_racer(racers[0], 0);
+            }
+
+            for (auto& interim_thread : interim_threads)
+            {
+                interim_thread.request_stop();
+                interim_thread.join();
+            }
         }
 
+        const auto selected = race.select_racer();
+        auto&      racer    = racers[selected];
+        d_exit_code         = racer.exit_code;
+
+        exit_message = d_exit_code == SolverExitCode::forced_termination
+                     ? std::format("Failed solving by timeout. (limit:{} {})", d_ilp_data.max_seconds, racer.watchdog->kill_reason())
+                     : exit_code_to_message(d_exit_code);
+
         if (d_ilp_data.log_level)
+        {
+            if (!d_racers.empty())
+                std::cout << "Portfolio: Solution of racer " << selected << (race.winner() >= 0 ? " (winner)\n" : "\n");
             std::cout << "External Solver messages: \"" << exit_message << "\" (Exit Code "
                       << static_cast<int>(d_exit_code) << ")\n";
+        }
 
-        communicator.read_solution_data(&d_ilp_solution_data);
+        d_ilp_solution_data = race.take_solution(selected);
     }
     // Rethrow all exceptions as SolverExeExceptions, so they can be easily traced back to this function.
     catch (const std::exception& p_e)
@@ -4,17 +4,41 @@
 
 #include "ilp_data.hpp"
 #include "ilp_solver_collect.hpp"
+#include "portfolio_racer.hpp"
+#include "solver_exit_code.hpp"
+#include "watchdog_policy.hpp"
 
+#include <boost/filesystem/path.hpp>
+#include <functional>
+#include <memory>
+#include <stop_token>
 #include <string>
+#include <vector>
 
 namespace ilp_solver
 {
+    class CommunicationParent;
+    class PortfolioRace;
+    class Watchdog;
+    class WorkerPool;
+
     // Receives data about the ILP, writes it into shared memory,
     // and starts a new solver process that solves the ILP.
     class ILPSolverStub final : public ILPSolverCollect
     {
         public:
-            ILPSolverStub(const std::string& p_executable_basename, bool p_throw_on_all_crashes);
+            // If p_num_workers > 0, the ILPs are solved by a WorkerPool of at most that many long-lived processes,
+            // which is shared by all stubs with the same executable. Otherwise, a new process is started for each ILP.
+            // p_watchdog_policy decides how long to wait for a process that exceeds the time limit.
+            // If p_prelaunch, a process is started right away. It creates its solver and waits for the ILP,
+            // which hides this startup time behind building the model. Then each ILP of the stub is solved
+            // by that process as by a WorkerPool, and a crashed process is replaced right after the solve.
+            // p_backend selects the solver of the process. Its parameters can be set by set_solver_parameter.
+            // If p_racers are given, each ILP is solved by one process per racer at the same time instead (see solve_impl).
+            ILPSolverStub(const std::string& p_executable_basename, bool p_throw_on_all_crashes, int p_num_workers = 0,
+                          const WatchdogPolicy& p_watchdog_policy = {}, bool p_prelaunch = false,
+                          SolverBackend p_backend = SolverBackend::DEFAULT, std::vector<PortfolioRacer> p_racers = {});
+            ~ILPSolverStub() override;
 
             std::vector<double> get_solution()                const override { return d_ilp_solution_data.solution; };
             std::vector<double> get_dual_sol()                const override { return d_ilp_solution_data.dual_sol; };
@@ -26,20 +50,53 @@ namespace ilp_solver
 
             void reset_solution() override;
 
+            // The solver process writes each improving solution to shared memory as soon as it finds one.
+            // p_interim_handler is called on these from a separate thread while minimize()/maximize() run,
+            // but never concurrently with itself and never after they have returned.
+            void set_interim_results(std::function<void(ILPSolutionData*)> p_interim_handler) override;
+
         private:
-            const std::string d_executable_basename;
-            const bool        d_throw_on_all_crashes;
-            SolverExitCode    d_exit_code{SolverExitCode::ok};
+            const std::string                 d_executable_basename;
+            const bool                        d_throw_on_all_crashes;
+            const int                         d_num_workers;
+            const WatchdogPolicy              d_watchdog_policy;
+            const bool                        d_prelaunch;
+            const std::vector<PortfolioRacer> d_racers;
+            std::unique_ptr<WorkerPool>       d_own_pool;   // Of the prelaunched processes if d_num_workers == 0.
+            SolverExitCode                    d_exit_code{SolverExitCode::ok};
+
+            ILPSolutionData                   d_ilp_solution_data;
+
+            std::function<void(ILPSolutionData*)> d_interim_handler;
 
-            ILPSolutionData   d_ilp_solution_data;
+            // The shared WorkerPool if d_num_workers > 0, otherwise d_own_pool.
+            WorkerPool& worker_pool() const;
 
-            // Runs d_executable_basename.exe.
-            // Puts its exit code in d_exit_code.
+            // Runs d_executable_basename.exe, or passes the ILP to a worker of the WorkerPool.
+            // With d_racers, one process per racer solves the ILP by the rules of PortfolioRace.
+            // The racers that should stop are asked to (and killed by their Watchdog if they do not).
+            // Each improving solution of any racer is passed to the interim handler, such that the racers share
+            // their incumbents at the stub. (Running solvers can not take a new incumbent or bound.)
+            // Puts the exit code of the racer whose solution is taken in d_exit_code.
             // If d_exit_code indicates a severe error or d_throw_on_all_crashes==true, in addition SolverExeException is thrown.
             // If d_exit_code indicates a known CBC problem that should be ignored silently, we test if the stub works at least with a tiny LP (function stub_tester).
             // - If that works, we keep d_exit_code, but do not throw.
             // - If that does not work, we change d_error_code and report that stub_tester does not work either.
             void solve_impl() override;
+
+            // Offers the solutions of the solver process to v_race for the interim handler until stop is requested.
+            static void deliver_interim_results(CommunicationParent* v_communicator, PortfolioRace* v_race, std::stop_token p_stop);
+
+            // Writes d_ilp_data for v_communicator, with the backend and the additional parameters of p_racer if given.
+            std::string write_ilp_data(CommunicationParent* v_communicator, const PortfolioRacer* p_racer);
+
+            // Solves the ILP in p_shared_memory_name by run_process or a worker of the WorkerPool.
+            SolverExitCode run_solver(const std::string& p_shared_memory_name, Watchdog* v_watchdog);
+
+            // Starts p_executable_path for the ILP in p_shared_memory_name and waits for it.
+            // Kills it when v_watchdog says so and returns SolverExitCode::forced_termination then.
+            SolverExitCode run_process(const boost::filesystem::path& p_executable_path,
+                                       const std::string& p_shared_memory_name, Watchdog* v_watchdog) const;
     };
 }
 
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "ilp_data.hpp"
+#include "utility.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <utility>
+
+namespace ilp_solver
+{
+    // Passes the improving solutions of one solver to its interim handler as its InterimPolicy says.
+    // Solutions are written into one buffer, which is allocated once per solve, and only if they are passed (or coalesced).
+    // The implementations call start before each solve, offer for each solution found, poll from their regular checks
+    // (where stop_requested is called) and finish after the solve. None of these calls may run concurrently,
+    // so solvers that call back from several threads serialize them (see ILPSolverCbc::d_event_mutex).
+    class InterimDelivery
+    {
+        public:
+            void set_handler(std::function<void(ILPSolutionData*)> p_handler) { d_handler = std::move(p_handler); }
+            bool has_handler() const { return static_cast<bool>(d_handler); }
+
+            // Forgets the solutions of the last solve and allocates the buffer for solutions of p_num_variables values.
+            void start(const InterimPolicy& p_policy, ObjectiveSense p_sense, int p_num_variables)
+            {
+                d_policy        = p_policy;
+                d_sense         = p_sense == ObjectiveSense::MINIMIZE ? 1. : -1.;
+                d_num_variables = p_num_variables;
+                d_next_time     = Clock::time_point::min();
+                d_pending       = false;
+                d_passed        = false;
+
+                d_buffer = ILPSolutionData(p_sense);
+                if (d_handler)
+                    d_buffer.solution.resize(d_num_variables);
+            }
+
+            // A solution of value p_objective has been found. If the policy takes it, p_fill(double*) writes its values
+            // and returns whether it could. If not, the solution is dropped, and so is a pending one whose values it has overwritten.
+            template<typename Fill>
+            void offer(double p_objective, Fill&& p_fill)
+            {
+                if (!d_handler)
+                    return;
+                // Better than the last solution taken, and sufficiently better than the last one passed.
+                if (d_buffer.solution_status != SolutionStatus::NO_SOLUTION && !improves(p_objective, d_buffer.objective, 0.))
+                    return;
+                if (d_passed && !improves(p_objective, d_passed_objective, d_policy.min_relative_improvement))
+                    return;
+                if (!d_policy.coalesce && !is_due())
+                    return;
+
+                d_buffer.solution.resize(d_num_variables); // Only allocates if the handler has taken the array.
+                if (!p_fill(d_buffer.solution.data()))
+                {
+                    d_pending = false;
+                    return;
+                }
+                d_buffer.objective       = p_objective;
+                d_buffer.solution_status = SolutionStatus::SUBOPTIMAL;
+                d_pending                = true;
+                poll();
+            }
+
+            // Passes a coalesced solution once the interval has passed.
+            void poll()
+            {
+                if (d_pending && is_due())
+                    pass();
+            }
+
+            // Passes a coalesced solution, regardless of the interval.
+            void finish()
+            {
+                if (d_pending)
+                    pass();
+            }
+
+        private:
+            using Clock = std::chrono::steady_clock;
+
+            std::function<void(ILPSolutionData*)> d_handler;
+            InterimPolicy                         d_policy{};
+            double                                d_sense{1.};
+            int                                   d_num_variables{0};
+
+            ILPSolutionData   d_buffer;                 // Last solution taken, which is pending or has been passed.
+            bool              d_pending{false};
+            bool              d_passed{false};          // Whether any solution has been passed in this solve.
+            double            d_passed_objective{0.};
+            Clock::time_point d_next_time{Clock::time_point::min()};
+
+            bool improves(double p_objective, double p_reference, double p_min_relative_improvement) const
+            {
+                return d_sense*(p_reference - p_objective) > p_min_relative_improvement*std::abs(p_reference);
+            }
+
+            // Only asks the clock if there is an interval.
+            bool is_due() const
+            {
+                return d_policy.min_interval_seconds <= 0. || Clock::now() >= d_next_time;
+            }
+
+            void pass()
+            {
+                d_pending          = false;
+                d_passed           = true;
+                d_passed_objective = d_buffer.objective;
+                if (d_policy.min_interval_seconds > 0.)
+                    d_next_time = time_after(Clock::now(), d_policy.min_interval_seconds);
+                d_handler(&d_buffer);
+            }
+    };
+}
@@ -0,0 +1,171 @@
+#include "model_evaluator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace ilp_solver
+{
+
+// Number of candidates that evaluate_batch evaluates at once.
+// The values of a block are stored variable by variable, such that the same operation applies to contiguous values.
+constexpr int c_block_size = 8;
+
+using Block = std::array<double, c_block_size>;
+
+
+static bool is_integral(VariableTypeArray p_variable_type, int p_variable)
+{
+    return !p_variable_type.empty() && p_variable_type[p_variable] != VariableType::CONTINUOUS;
+}
+
+
+// For the bounds of variables, see SolutionEvaluation. Without branches, such that the loops over a block vectorize.
+// An infinite bound gives 0, as does a value that is not a number.
+static double absolute_violation(double p_value, double p_lower, double p_upper)
+{
+    return std::max(std::max(0., p_lower - p_value), std::max(0., p_value - p_upper));
+}
+
+
+// For the bounds of constraints: Relative to the violated bound, see SolutionEvaluation. Otherwise like absolute_violation.
+static double relative_violation(double p_value, double p_lower, double p_upper)
+{
+    const auto below = std::max(0., p_lower - p_value);
+    const auto above = std::max(0., p_value - p_upper);
+    return std::max(below/std::max(1., std::abs(p_lower)), above/std::max(1., std::abs(p_upper)));
+}
+
+
+// Distance to the nearest integer. Unlike std::round, std::floor compiles to a single instruction.
+static double fractionality(double p_value)
+{
+    return std::abs(p_value - std::floor(p_value + 0.5));
+}
+
+
+ModelEvaluator::ModelEvaluator(const ILPDataView& p_model)
+    : ModelEvaluator(p_model.objective, p_model.variable_lower, p_model.variable_upper, p_model.variable_type,
+                     p_model.constraint_lower, p_model.constraint_upper, p_model.matrix.d_row_starts,
+                     p_model.matrix.d_indices, p_model.matrix.d_values)
+{}
+
+
+ModelEvaluator::ModelEvaluator(ValueArray p_objective, ValueArray p_variable_lower, ValueArray p_variable_upper,
+                               VariableTypeArray p_variable_type, ValueArray p_constraint_lower,
+                               ValueArray p_constraint_upper, IndexArray p_row_starts, IndexArray p_col_indices,
+                               ValueArray p_values)
+    : d_objective(p_objective), d_variable_lower(p_variable_lower), d_variable_upper(p_variable_upper),
+      d_variable_type(p_variable_type), d_constraint_lower(p_constraint_lower), d_constraint_upper(p_constraint_upper),
+      d_row_starts(p_row_starts), d_col_indices(p_col_indices), d_values(p_values)
+{
+    assert(p_variable_lower.size() == p_objective.size() && p_variable_upper.size() == p_objective.size());
+    assert(p_variable_type.empty() || p_variable_type.size() == p_objective.size());
+    assert(p_constraint_upper.size() == p_constraint_lower.size());
+    assert(p_row_starts.size() == p_constraint_lower.size() + 1 || (p_row_starts.empty() && p_constraint_lower.empty()));
+    assert(p_col_indices.size() == p_values.size());
+    assert(p_row_starts.empty() || p_row_starts.back() == isize(p_values));
+}
+
+
+SolutionEvaluation ModelEvaluator::evaluate(ValueArray p_solution, std::span<double> r_activities) const
+{
+    assert(isize(p_solution) == num_variables());
+    assert(r_activities.empty() || isize(r_activities) == num_constraints());
+
+    SolutionEvaluation evaluation;
+    for (auto j = 0; j < num_variables(); ++j)
+    {
+        const auto value = p_solution[j];
+        evaluation.objective          += d_objective[j]*value;
+        evaluation.max_bound_violation = std::max(evaluation.max_bound_violation,
+                                                  absolute_violation(value, d_variable_lower[j], d_variable_upper[j]));
+        if (is_integral(d_variable_type, j))
+            evaluation.max_integrality_violation = std::max(evaluation.max_integrality_violation,
+                                                            fractionality(value));
+    }
+
+    for (auto i = 0; i < num_constraints(); ++i)
+    {
+        auto activity = 0.;
+        for (auto k = d_row_starts[i]; k < d_row_starts[i + 1]; ++k)
+            activity += d_values[k]*p_solution[d_col_indices[k]];
+        evaluation.max_row_violation = std::max(evaluation.max_row_violation,
+                                                relative_violation(activity, d_constraint_lower[i], d_constraint_upper[i]));
+        if (!r_activities.empty())
+            r_activities[i] = activity;
+    }
+    return evaluation;
+}
+
+
+void ModelEvaluator::evaluate_batch(ValueArray p_candidates, std::span<SolutionEvaluation> r_evaluations) const
+{
+    const auto num_candidates = isize(r_evaluations);
+    const auto num_variables  = this->num_variables();
+    assert(std::cmp_equal(p_candidates.size(), static_cast<long long>(num_candidates)*num_variables));
+
+    // values[j][c] is the value of variable j in candidate c of the current block. Unused candidates stay 0.
+    std::vector<Block> values(num_variables, Block{});
+    for (auto first = 0; first < num_candidates; first += c_block_size)
+    {
+        const auto block_size = std::min(c_block_size, num_candidates - first);
+        for (auto c = 0; c < block_size; ++c)
+        {
+            const auto candidate = p_candidates.subspan(static_cast<std::size_t>(first + c)*num_variables, num_variables);
+            for (auto j = 0; j < num_variables; ++j)
+                values[j][c] = candidate[j];
+        }
+        if (block_size < c_block_size)
+        {
+            for (auto& value : values)
+                std::fill(value.begin() + block_size, value.end(), 0.);
+        }
+
+        Block objective{};
+        Block bound_violation{};
+        Block integrality_violation{};
+        for (auto j = 0; j < num_variables; ++j)
+        {
+            const auto& value = values[j];
+            const auto  cost  = d_objective[j];
+            const auto  lower = d_variable_lower[j];
+            const auto  upper = d_variable_upper[j];
+            for (auto c = 0; c < c_block_size; ++c)
+            {
+                objective[c]       += cost*value[c];
+                bound_violation[c]  = std::max(bound_violation[c], absolute_violation(value[c], lower, upper));
+            }
+            if (is_integral(d_variable_type, j))
+            {
+                for (auto c = 0; c < c_block_size; ++c)
+                    integrality_violation[c] = std::max(integrality_violation[c], fractionality(value[c]));
+            }
+        }
+
+        Block row_violation{};
+        for (auto i = 0; i < num_constraints(); ++i)
+        {
+            Block activity{};
+            for (auto k = d_row_starts[i]; k < d_row_starts[i + 1]; ++k)
+            {
+                const auto  factor = d_values[k];
+                const auto& value  = values[d_col_indices[k]];
+                for (auto c = 0; c < c_block_size; ++c)
+                    activity[c] += factor*value[c];
+            }
+            const auto lower = d_constraint_lower[i];
+            const auto upper = d_constraint_upper[i];
+            for (auto c = 0; c < c_block_size; ++c)
+                row_violation[c] = std::max(row_violation[c], relative_violation(activity[c], lower, upper));
+        }
+
+        for (auto c = 0; c < block_size; ++c)
+            r_evaluations[first + c] = {objective[c], bound_violation[c], integrality_violation[c], row_violation[c]};
+    }
+}
+
+} // namespace ilp_solver
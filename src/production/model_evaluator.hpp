@@ -0,0 +1,73 @@
+#pragma once
+
+#include "ilp_data.hpp"
+#include "ilp_solver_interface.hpp"
+
+#include <cmath>
+#include <span>
+
+namespace ilp_solver
+{
+    // Largest violation of a solution that is still considered feasible, like the default tolerances of the solvers.
+    constexpr double c_feasibility_tolerance{1e-6};
+
+    // What ModelEvaluator computes for a solution. The violations are 0 if there is none.
+    // A violation of the bound of a constraint is relative to the bound if that exceeds 1 in absolute value,
+    // i.e., divided by max(1, |bound|). Thus, rounding errors in the activities of rows with large factors or bounds
+    // do not make a solution infeasible. Violations of the bounds of variables are absolute, like the tolerances
+    // that CBC and HiGHS apply to them.
+    struct SolutionEvaluation
+    {
+        double objective{0.};
+        double max_bound_violation{0.};       // Of the bounds of the variables.
+        double max_integrality_violation{0.}; // Distance of integer and binary variables to the nearest integer (absolute).
+        double max_row_violation{0.};         // Of the bounds of the constraints by their activities.
+
+        // A value that is not a number makes the objective NaN, and thus the solution infeasible.
+        bool is_feasible(double p_tolerance = c_feasibility_tolerance) const
+        {
+            return !std::isnan(objective) && max_bound_violation <= p_tolerance
+                && max_integrality_violation <= p_tolerance && max_row_violation <= p_tolerance;
+        }
+    };
+
+
+    // Computes the objective and the violations of solutions of a model with its constraint matrix in CSR format,
+    // like ILPData after flush(). This is much cheaper than letting a solver check a solution,
+    // e.g. to check start solutions or to screen the candidates of a heuristic before passing the best one to a solver.
+    // The evaluator only refers to the arrays of the model, which must outlive it.
+    class ModelEvaluator
+    {
+        public:
+            explicit ModelEvaluator(const ILPDataView& p_model);
+
+            // The arrays as in ILPSolverInterface::add_variables and add_constraints.
+            // p_variable_type may be empty if all variables are continuous.
+            ModelEvaluator(ValueArray p_objective, ValueArray p_variable_lower, ValueArray p_variable_upper,
+                           VariableTypeArray p_variable_type, ValueArray p_constraint_lower, ValueArray p_constraint_upper,
+                           IndexArray p_row_starts, IndexArray p_col_indices, ValueArray p_values);
+
+            int num_variables  () const { return isize(d_objective); }
+            int num_constraints() const { return isize(d_constraint_lower); }
+
+            // p_solution has a value for each variable.
+            // If r_activities is not empty, it gets the activity of each constraint.
+            SolutionEvaluation evaluate(ValueArray p_solution, std::span<double> r_activities = {}) const;
+
+            // Evaluates r_evaluations.size() candidates, whose solutions are stored one after the other in p_candidates.
+            // Much faster than evaluating them one by one: The matrix is traversed once per block of candidates,
+            // and the loops over the candidates of a block can be vectorized by the compiler.
+            void evaluate_batch(ValueArray p_candidates, std::span<SolutionEvaluation> r_evaluations) const;
+
+        private:
+            ValueArray        d_objective;
+            ValueArray        d_variable_lower;
+            ValueArray        d_variable_upper;
+            VariableTypeArray d_variable_type;
+            ValueArray        d_constraint_lower;
+            ValueArray        d_constraint_upper;
+            IndexArray        d_row_starts;
+            IndexArray        d_col_indices;
+            ValueArray        d_values;
+    };
+}
@@ -0,0 +1,551 @@
+#include "mps_reader.hpp"
+
+#include "utility.hpp"
+
+#include <array>
+#include <bit>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace ip = boost::interprocess;
+
+constexpr auto c_mps_infinity = 1e30;
+constexpr auto c_max_tokens   = 8;
+
+namespace ilp_solver
+{
+namespace
+{
+    // Splits the mapped file into lines and each line into tokens separated by whitespace.
+    // Tokens are views into the mapped file, so no memory is allocated per line or token.
+    class MpsTokenizer
+    {
+    public:
+        MpsTokenizer(const char* p_begin, const char* p_end, const std::string& p_filename)
+            : d_current(p_begin), d_end(p_end), d_filename(p_filename)
+        {}
+
+        // Advances to the next line that is neither empty nor a comment. Returns false at the end of the file.
+        bool next_line()
+        {
+            while (d_current != d_end)
+            {
+                const auto* line_end = static_cast<const char*>(std::memchr(d_current, '\n', d_end - d_current));
+                if (!line_end)
+                    line_end = d_end;
+
+                const auto* begin = d_current;
+                d_current         = line_end == d_end ? d_end : line_end + 1;
+                ++d_line_number;
+
+                if (begin == line_end || *begin == '*')
+                    continue;
+
+                d_is_header  = *begin != ' ' && *begin != '\t';
+                d_num_tokens = 0;
+                for (const auto* pos = begin; pos != line_end;)
+                {
+                    while (pos != line_end && is_space(*pos))
+                        ++pos;
+                    const auto* token_begin = pos;
+                    while (pos != line_end && !is_space(*pos))
+                        ++pos;
+                    if (token_begin == pos)
+                        break;
+                    if (d_num_tokens == c_max_tokens)
+                        error("Too many fields.");
+                    d_tokens[d_num_tokens++] = std::string_view(token_begin, pos - token_begin);
+                }
+                if (d_num_tokens > 0)
+                    return true;
+            }
+            return false;
+        }
+
+        bool             is_header()            const { return d_is_header; }
+        int              num_tokens()           const { return d_num_tokens; }
+        std::string_view token(int p_index)     const { return d_tokens[p_index]; }
+
+        double number(int p_index) const
+        {
+            auto token = token_or_error(p_index);
+            if (token.starts_with('+'))
+                token.remove_prefix(1);
+
+            double value;
+            const auto [end, error_code] = std::from_chars(token.data(), token.data() + token.size(), value);
+            if (error_code != std::errc() || end != token.data() + token.size())
+                error(std::format("\"{}\" is not a number.", token));
+
+            if (value >= c_mps_infinity)
+                return c_pos_inf;
+            if (value <= -c_mps_infinity)
+                return c_neg_inf;
+            return value;
+        }
+
+        std::string_view token_or_error(int p_index) const
+        {
+            if (p_index >= d_num_tokens)
+                error("Too few fields.");
+            return d_tokens[p_index];
+        }
+
+        [[noreturn]] void error(const std::string& p_message) const
+        {
+            throw std::runtime_error(std::format("{}({}): {}", d_filename, d_line_number, p_message));
+        }
+
+    private:
+        static bool is_space(char p_char) { return p_char == ' ' || p_char == '\t' || p_char == '\r'; }
+
+        const char*                                d_current;
+        const char*                                d_end;
+        const std::string&                         d_filename;
+        int                                        d_line_number{0};
+        bool                                       d_is_header{false};
+        int                                        d_num_tokens{0};
+        std::array<std::string_view, c_max_tokens> d_tokens;
+    };
+
+
+    // Maps names to indices. Open addressing with linear probing keeps lookups within one or two cache lines,
+    // which matters since there is a lookup for every entry of the matrix.
+    class NameIndex
+    {
+    public:
+        explicit NameIndex(int p_expected_size = 512) : d_slots(std::bit_ceil(2 * static_cast<std::size_t>(p_expected_size) + 1)) {}
+
+        // Returns false if p_name is already contained.
+        bool insert(std::string_view p_name, int p_index)
+        {
+            if (2 * (d_size + 1) > isize(d_slots))
+                grow();
+
+            auto& slot = find_slot(p_name, hash(p_name));
+            if (slot.index != c_empty)
+                return false;
+
+            slot = {hash(p_name), p_name, p_index};
+            ++d_size;
+            return true;
+        }
+
+        // Returns p_default if p_name is not contained.
+        int find(std::string_view p_name, int p_default) const
+        {
+            const auto& slot = find_slot(p_name, hash(p_name));
+            return slot.index == c_empty ? p_default : slot.index;
+        }
+
+    private:
+        static constexpr int c_empty = std::numeric_limits<int>::min();
+
+        struct Slot
+        {
+            std::size_t      hash{};
+            std::string_view name;
+            int              index{c_empty};
+        };
+
+        // FNV-1a
+        static std::size_t hash(std::string_view p_name)
+        {
+            std::uint64_t result = 14695981039346656037ull;
+            for (auto c : p_name)
+                result = (result ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+            return static_cast<std::size_t>(result);
+        }
+
+        Slot& find_slot(std::string_view p_name, std::size_t p_hash)
+        {
+            return const_cast<Slot&>(std::as_const(*this).find_slot(p_name, p_hash));
+        }
+
+        const Slot& find_slot(std::string_view p_name, std::size_t p_hash) const
+        {
+            const auto mask = d_slots.size() - 1;
+            for (auto pos = p_hash & mask;; pos = (pos + 1) & mask)
+            {
+                const auto& slot = d_slots[pos];
+                if (slot.index == c_empty || (slot.hash == p_hash && slot.name == p_name))
+                    return slot;
+            }
+        }
+
+        void grow()
+        {
+            auto old_slots = std::exchange(d_slots, std::vector<Slot>(2 * d_slots.size()));
+            for (const auto& slot : old_slots)
+            {
+                if (slot.index != c_empty)
+                    find_slot(slot.name, slot.hash) = slot;
+            }
+        }
+
+        std::vector<Slot> d_slots; // The size is a power of two.
+        int               d_size{0};
+    };
+
+
+    enum class Section { NONE, NAME, OBJSENSE, ROWS, COLUMNS, RHS, RANGES, BOUNDS, ENDATA };
+
+    constexpr auto c_objective_row = -1;
+    constexpr auto c_ignored_row   = -2;
+    constexpr auto c_unknown       = -3;
+
+
+    Section to_section(const MpsTokenizer& p_tokenizer)
+    {
+        const auto name = p_tokenizer.token(0);
+        if (name == "NAME")     return Section::NAME;
+        if (name == "OBJSENSE") return Section::OBJSENSE;
+        if (name == "ROWS")     return Section::ROWS;
+        if (name == "COLUMNS")  return Section::COLUMNS;
+        if (name == "RHS")      return Section::RHS;
+        if (name == "RANGES")   return Section::RANGES;
+        if (name == "BOUNDS")   return Section::BOUNDS;
+        if (name == "ENDATA")   return Section::ENDATA;
+        p_tokenizer.error(std::format("Unsupported section {}.", name));
+    }
+
+
+    ObjectiveSense to_objective_sense(const MpsTokenizer& p_tokenizer, std::string_view p_sense)
+    {
+        if (p_sense == "MAX" || p_sense == "MAXIMIZE")
+            return ObjectiveSense::MAXIMIZE;
+        if (p_sense == "MIN" || p_sense == "MINIMIZE")
+            return ObjectiveSense::MINIMIZE;
+        p_tokenizer.error(std::format("Unknown objective sense {}.", p_sense));
+    }
+
+
+    // Collects the model as given in the file, i.e. column-wise, and converts it to ILPData in the end.
+    class MpsParser
+    {
+    public:
+        explicit MpsParser(MpsTokenizer& p_tokenizer) : d_tokenizer(p_tokenizer) {}
+
+        ILPData parse()
+        {
+            auto section = Section::NONE;
+            while (section != Section::ENDATA && d_tokenizer.next_line())
+            {
+                if (d_tokenizer.is_header())
+                {
+                    section = to_section(d_tokenizer);
+                    // Free MPS allows the objective sense in the header line.
+                    if (section == Section::OBJSENSE && d_tokenizer.num_tokens() > 1)
+                        d_data.objective_sense = to_objective_sense(d_tokenizer, d_tokenizer.token(1));
+                    continue;
+                }
+
+                switch (section)
+                {
+                case Section::OBJSENSE: d_data.objective_sense = to_objective_sense(d_tokenizer, d_tokenizer.token(0)); break;
+                case Section::ROWS:     parse_row();    break;
+                case Section::COLUMNS:  parse_column(); break;
+                case Section::RHS:      parse_rhs();    break;
+                case Section::RANGES:   parse_range();  break;
+                case Section::BOUNDS:   parse_bound();  break;
+                default:                d_tokenizer.error("Data outside of a section.");
+                }
+            }
+            if (section != Section::ENDATA)
+                d_tokenizer.error("Missing ENDATA.");
+
+            return to_ilp_data();
+        }
+
+    private:
+        void parse_row()
+        {
+            const auto type = d_tokenizer.token(0);
+            const auto name = d_tokenizer.token_or_error(1);
+            if (type.size() != 1 || std::string_view("NELG").find(type[0]) == std::string_view::npos)
+                d_tokenizer.error(std::format("Unknown row type {}.", type));
+
+            auto index = isize(d_row_types);
+            if (type[0] == 'N')
+                index = d_has_objective ? c_ignored_row : c_objective_row;
+
+            if (!d_rows.insert(name, index))
+                d_tokenizer.error(std::format("Duplicate row {}.", name));
+
+            if (type[0] == 'N')
+                d_has_objective = true;
+            else
+            {
+                d_row_types.push_back(type[0]);
+                d_rhs.push_back(0.);
+                d_ranges.push_back(std::numeric_limits<double>::quiet_NaN());
+            }
+        }
+
+
+        void parse_column()
+        {
+            // Integer markers: "name 'MARKER' 'INTORG'" and "name 'MARKER' 'INTEND'".
+            if (d_tokenizer.num_tokens() >= 3 && d_tokenizer.token(1) == "'MARKER'")
+            {
+                if (d_tokenizer.token(2) == "'INTORG'")
+                    d_integer_marker = true;
+                else if (d_tokenizer.token(2) == "'INTEND'")
+                    d_integer_marker = false;
+                else
+                    d_tokenizer.error(std::format("Unknown marker {}.", d_tokenizer.token(2)));
+                return;
+            }
+
+            const auto name = d_tokenizer.token(0);
+            if (d_col_names.empty() || d_col_names.back() != name)
+                add_column(name);
+
+            if (d_tokenizer.num_tokens() != 3 && d_tokenizer.num_tokens() != 5)
+                d_tokenizer.error("Expected a column followed by one or two pairs of row and value.");
+
+            for (int k = 1; k < d_tokenizer.num_tokens(); k += 2)
+            {
+                const auto row   = row_index(d_tokenizer.token(k));
+                const auto value = d_tokenizer.number(k + 1);
+                if (row == c_objective_row)
+                    d_data.objective.back() = value;
+                else if (row != c_ignored_row && value != 0.)
+                {
+                    d_row_indices.push_back(row);
+                    d_values.push_back(value);
+                }
+            }
+            d_col_starts.back() = isize(d_row_indices);
+        }
+
+
+        void add_column(std::string_view p_name)
+        {
+            if (!d_cols.insert(p_name, isize(d_col_names)))
+                d_tokenizer.error(std::format("Column {} is not contiguous in the COLUMNS section.", p_name));
+            d_col_names.push_back(p_name);
+            d_col_starts.push_back(isize(d_row_indices));
+            d_data.objective.push_back(0.);
+            d_data.variable_lower.push_back(0.);
+            d_data.variable_upper.push_back(c_pos_inf);
+            d_data.variable_type.push_back(d_integer_marker ? VariableType::INTEGER : VariableType::CONTINUOUS);
+        }
+
+
+        // RHS and RANGES lines are "[set] row value [row value]". Hence, an odd number of tokens means there is a set name.
+        template<typename Function>
+        void parse_row_values(Function p_function)
+        {
+            if (d_tokenizer.num_tokens() < 2 || d_tokenizer.num_tokens() > 5)
+                d_tokenizer.error("Expected an optional set name followed by one or two pairs of row and value.");
+
+            for (int k = d_tokenizer.num_tokens() % 2; k < d_tokenizer.num_tokens(); k += 2)
+            {
+                const auto row = row_index(d_tokenizer.token(k));
+                if (row >= 0)
+                    p_function(row, d_tokenizer.number(k + 1));
+            }
+        }
+
+
+        void parse_rhs()
+        {
+            parse_row_values([this](int p_row, double p_value) { d_rhs[p_row] = p_value; });
+        }
+
+
+        void parse_range()
+        {
+            parse_row_values([this](int p_row, double p_value) { d_ranges[p_row] = p_value; });
+        }
+
+
+        // BOUNDS lines are "type [set] column [value]", where types BV, FR, MI and PL have no value.
+        void parse_bound()
+        {
+            const auto type      = d_tokenizer.token(0);
+            const bool has_value = !(type == "BV" || type == "FR" || type == "MI" || type == "PL");
+            const auto col_token = d_tokenizer.num_tokens() > (has_value ? 3 : 2) ? 2 : 1;
+            const auto col       = col_index(d_tokenizer.token_or_error(col_token));
+            const auto value     = has_value ? d_tokenizer.number(col_token + 1) : 0.;
+
+            auto& lower = d_data.variable_lower[col];
+            auto& upper = d_data.variable_upper[col];
+            auto& var_type = d_data.variable_type[col];
+
+            if (type == "UP" || type == "UI")
+            {
+                // By convention, a negative upper bound without a lower bound makes the variable unbounded below.
+                if (value < 0. && lower == 0.)
+                    lower = c_neg_inf;
+                upper = value;
+            }
+            else if (type == "LO" || type == "LI")
+                lower = value;
+            else if (type == "FX")
+                lower = upper = value;
+            else if (type == "FR")
+            {
+                lower = c_neg_inf;
+                upper = c_pos_inf;
+            }
+            else if (type == "MI")
+                lower = c_neg_inf;
+            else if (type == "PL")
+                upper = c_pos_inf;
+            else if (type == "BV")
+            {
+                var_type = VariableType::BINARY;
+                lower    = 0.;
+                upper    = 1.;
+            }
+            else
+                d_tokenizer.error(std::format("Unsupported bound type {}.", type));
+
+            if (type == "UI" || type == "LI")
+                var_type = VariableType::INTEGER;
+        }
+
+
+        int row_index(std::string_view p_name) const
+        {
+            const auto index = d_rows.find(p_name, c_unknown);
+            if (index == c_unknown)
+                d_tokenizer.error(std::format("Unknown row {}.", p_name));
+            return index;
+        }
+
+
+        int col_index(std::string_view p_name) const
+        {
+            const auto index = d_cols.find(p_name, c_unknown);
+            if (index == c_unknown)
+                d_tokenizer.error(std::format("Unknown column {}.", p_name));
+            return index;
+        }
+
+
+        ILPData to_ilp_data()
+        {
+            // Binary variables must have the bounds 0 and 1, which may have been changed after the BV bound.
+            for (int j = 0; j < isize(d_data.variable_type); ++j)
+            {
+                if (d_data.variable_type[j] == VariableType::BINARY && (d_data.variable_lower[j] != 0. || d_data.variable_upper[j] != 1.))
+                    d_data.variable_type[j] = VariableType::INTEGER;
+            }
+
+            const auto num_rows = isize(d_row_types);
+            d_data.constraint_lower.resize(num_rows);
+            d_data.constraint_upper.resize(num_rows);
+            for (int i = 0; i < num_rows; ++i)
+            {
+                const auto rhs   = d_rhs[i];
+                const auto range = d_ranges[i];
+                auto&      lower = d_data.constraint_lower[i];
+                auto&      upper = d_data.constraint_upper[i];
+                switch (d_row_types[i])
+                {
+                case 'E':
+                    lower = std::isnan(range) || range >= 0. ? rhs : rhs + range;
+                    upper = std::isnan(range) || range <= 0. ? rhs : rhs + range;
+                    break;
+                case 'L':
+                    lower = std::isnan(range) ? c_neg_inf : rhs - std::abs(range);
+                    upper = rhs;
+                    break;
+                default:
+                    lower = rhs;
+                    upper = std::isnan(range) ? c_pos_inf : rhs + std::abs(range);
+                }
+            }
+
+            // Convert the columns to rows by a counting sort.
+            auto& matrix = d_data.matrix;
+            matrix.d_row_starts.assign(num_rows + 1, 0);
+            matrix.d_indices.resize(d_row_indices.size());
+            matrix.d_values.resize(d_values.size());
+            for (auto row : d_row_indices)
+                ++matrix.d_row_starts[row + 1];
+            for (int i = 0; i < num_rows; ++i)
+                matrix.d_row_starts[i + 1] += matrix.d_row_starts[i];
+
+            std::vector<int> next(matrix.d_row_starts.begin(), matrix.d_row_starts.end() - 1);
+            for (int j = 0; j + 1 < isize(d_col_starts); ++j)
+            {
+                for (int k = d_col_starts[j]; k < d_col_starts[j + 1]; ++k)
+                {
+                    const auto pos          = next[d_row_indices[k]]++;
+                    matrix.d_indices[pos] = j;
+                    matrix.d_values[pos]  = d_values[k];
+                }
+            }
+            matrix.d_num_cols = num_rows > 0 ? isize(d_col_names) : 0;
+
+            return std::move(d_data);
+        }
+
+        MpsTokenizer& d_tokenizer;
+        ILPData       d_data;
+
+        NameIndex           d_rows;
+        std::vector<char>   d_row_types;
+        std::vector<double> d_rhs;
+        std::vector<double> d_ranges; // NaN if not given.
+        bool                d_has_objective{false};
+
+        NameIndex                     d_cols;
+        std::vector<std::string_view> d_col_names;
+        std::vector<int>              d_col_starts{0};
+        std::vector<int>              d_row_indices;
+        std::vector<double>           d_values;
+        bool                          d_integer_marker{false};
+    };
+} // namespace
+
+
+ILPData read_mps_file(const std::string& p_filename)
+{
+    const auto path = boost::filesystem::path(p_filename);
+    if (!boost::filesystem::is_regular_file(path) || boost::filesystem::is_empty(path))
+        throw std::runtime_error(std::format("{}: No such file or empty file.", p_filename));
+
+    try
+    {
+        const ip::file_mapping  file(path.c_str(), ip::read_only);
+        ip::mapped_region       region(file, ip::read_only);
+        region.advise(ip::mapped_region::advice_sequential);
+        const auto*             begin = static_cast<const char*>(region.get_address());
+
+        MpsTokenizer tokenizer(begin, begin + region.get_size(), p_filename);
+        return MpsParser(tokenizer).parse();
+    }
+    catch (const ip::interprocess_exception& p_e)
+    {
+        throw std::runtime_error(std::format("{}: {}", p_filename, p_e.what()));
+    }
+}
+
+
+ObjectiveSense read_mps_file(const std::string& p_filename, ILPSolverInterface* v_solver)
+{
+    const auto data = read_mps_file(p_filename);
+    v_solver->add_variables(data.objective, data.variable_lower, data.variable_upper, data.variable_type);
+    v_solver->add_constraints(data.constraint_lower, data.constraint_upper,
+                              data.matrix.d_row_starts, data.matrix.d_indices, data.matrix.d_values);
+    return data.objective_sense;
+}
+
+} // namespace ilp_solver
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "ilp_data.hpp"
+#include "ilp_solver_impl.hpp"
+#include "ilp_solver_interface.hpp"
+
+#include <string>
+
+namespace ilp_solver
+{
+    // Reads a model in free or fixed MPS format.
+    // The file is memory-mapped and tokenized in place. Only the names of rows and columns are stored (as views into the file).
+    // Supported sections: NAME, OBJSENSE, ROWS, COLUMNS (including integer markers), RHS, RANGES, BOUNDS and ENDATA.
+    // The first N row is the objective. Further N rows and constants in the objective are ignored.
+    // Names must not contain spaces, also in fixed MPS. Absolute values of at least 1e30 are treated as infinite.
+    // Throws std::runtime_error if the file can not be read or is malformed.
+    // The file name is converted to boost::filesystem::path internally, see print_mps_file.
+    ILPData read_mps_file(const std::string& p_filename);
+
+    // Reads the model as above and adds it to v_solver by add_variables and add_constraints.
+    // The objective sense is returned, since it is chosen by calling minimize() or maximize().
+    ObjectiveSense read_mps_file(const std::string& p_filename, ILPSolverInterface* v_solver);
+}
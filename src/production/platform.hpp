@@ -0,0 +1,8 @@
+#pragma once
+
+// Calling conventions and DLL exports are specific to Windows.
+// Elsewhere, all functions of the shared library are visible and use the default calling convention.
+#ifndef _WIN32
+#define __stdcall
+#define __declspec(x)
+#endif
@@ -0,0 +1,91 @@
+#include "portfolio_race.hpp"
+
+#include "utility.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace ilp_solver
+{
+
+static bool is_proven(SolutionStatus p_status)
+{
+    return p_status == SolutionStatus::PROVEN_OPTIMAL || p_status == SolutionStatus::PROVEN_INFEASIBLE
+        || p_status == SolutionStatus::PROVEN_UNBOUNDED;
+}
+
+
+PortfolioRace::PortfolioRace(int p_num_racers, ObjectiveSense p_sense, const std::function<void(ILPSolutionData*)>& p_interim_handler)
+    : d_sense(p_sense), d_interim_handler(p_interim_handler), d_best_interim(p_sense), d_results(p_num_racers)
+{
+    assert(p_num_racers > 0);
+}
+
+
+// Like the event handler of CBC, only solutions that improve on the last delivered one are passed on.
+void PortfolioRace::offer_interim(ILPSolutionData* v_solution)
+{
+    const auto      sense = d_sense == ObjectiveSense::MINIMIZE ? 1. : -1.;
+    std::lock_guard lock(d_mutex);
+    if (!d_interim_handler || d_interim_failed || v_solution->solution_status == SolutionStatus::NO_SOLUTION
+        || v_solution->solution.empty()
+        || (d_best_interim.solution_status != SolutionStatus::NO_SOLUTION && sense*v_solution->objective >= sense*d_best_interim.objective))
+        return;
+
+    d_best_interim = *v_solution;
+    try
+    {
+        d_interim_handler(v_solution);
+    }
+    catch (...)
+    {
+        d_interim_exception = std::current_exception();
+        d_interim_failed    = true;
+    }
+}
+
+
+void PortfolioRace::finish(int p_index, ILPSolutionData p_solution, bool p_failed)
+{
+    auto no_winner = -1;
+    if (is_proven(p_solution.solution_status))
+        d_winner.compare_exchange_strong(no_winner, p_index);
+    d_results[p_index].solution = std::move(p_solution);
+    d_results[p_index].failed   = p_failed;
+}
+
+
+void PortfolioRace::fail(int p_index, std::exception_ptr p_exception)
+{
+    d_results[p_index].failed    = true;
+    d_results[p_index].exception = std::move(p_exception);
+}
+
+
+int PortfolioRace::select_racer() const
+{
+    if (d_interim_exception)
+        std::rethrow_exception(d_interim_exception);
+    if (d_winner >= 0)
+        return d_winner;
+
+    const auto sense    = d_sense == ObjectiveSense::MINIMIZE ? 1. : -1.;
+    auto       selected = -1;
+    for (auto i = 0; i < isize(d_results); ++i)
+    {
+        const auto& solution = d_results[i].solution;
+        if (solution.solution_status != SolutionStatus::NO_SOLUTION
+            && (selected < 0 || sense*solution.objective < sense*d_results[selected].solution.objective))
+            selected = i;
+    }
+    if (selected >= 0)
+        return selected;
+
+    const auto failed = std::ranges::find_if(d_results, [](const Result& p_result) { return p_result.failed; });
+    selected          = failed == d_results.end() ? 0 : static_cast<int>(failed - d_results.begin());
+    if (d_results[selected].exception)
+        std::rethrow_exception(d_results[selected].exception);
+    return selected;
+}
+
+} // namespace ilp_solver
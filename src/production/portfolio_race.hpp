@@ -0,0 +1,73 @@
+#pragma once
+
+#include "ilp_data.hpp"
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ilp_solver
+{
+    // State of one solve of a portfolio that the threads of its racers share,
+    // for the processes of ILPSolverStub as for the solvers of ILPSolverPortfolio. The rules of the race:
+    // - The first racer that proves its result (optimal, infeasible or unbounded) wins, and the others should stop.
+    // - Without a winner, the best solution of all racers is taken.
+    // - A racer that fails, e.g. because its backend is not available, does not stop the others.
+    //   Its error is only reported if no racer has a solution.
+    // - Only solutions that improve on all solutions passed before are passed to the interim handler.
+    //   If the handler throws, the racers should stop, and the exception is rethrown after they have returned.
+    class PortfolioRace
+    {
+        public:
+            // p_interim_handler may be empty and must outlive the race.
+            PortfolioRace(int p_num_racers, ObjectiveSense p_sense, const std::function<void(ILPSolutionData*)>& p_interim_handler);
+
+            PortfolioRace(const PortfolioRace&)            = delete;
+            PortfolioRace& operator=(const PortfolioRace&) = delete;
+
+            // Serializes the calls of the handlers of the solver by the threads of the racers.
+            // Taken by offer_interim, so lock it only for the other handlers.
+            std::mutex& mutex() { return d_mutex; }
+
+            // Whether the racers should stop, because one has won or the interim handler has thrown. Lock-free.
+            bool is_decided() const { return d_winner >= 0 || d_interim_failed; }
+
+            // Passes *v_solution to the interim handler if it improves on all solutions passed before.
+            void offer_interim(ILPSolutionData* v_solution);
+
+            // Records the result of racer p_index once it has returned. It wins if its result is proven and no racer has won before.
+            // A failed racer may still have a solution, e.g. a process killed after its time limit.
+            void finish(int p_index, ILPSolutionData p_solution, bool p_failed = false);
+
+            // Records that racer p_index has thrown p_exception.
+            void fail(int p_index, std::exception_ptr p_exception);
+
+            // After all racers have returned: The winner, or the racer with the best solution, or the first that has failed,
+            // such that its error is reported. Rethrows the exception of the interim handler or of the selected racer.
+            int select_racer() const;
+
+            int             winner() const             { return d_winner; }
+            ILPSolutionData take_solution(int p_index) { return std::move(d_results[p_index].solution); }
+
+        private:
+            struct Result
+            {
+                ILPSolutionData    solution;
+                bool               failed{false};
+                std::exception_ptr exception;
+            };
+
+            const ObjectiveSense                         d_sense;
+            const std::function<void(ILPSolutionData*)>& d_interim_handler;
+
+            std::mutex                                   d_mutex;
+            ILPSolutionData                              d_best_interim;   // Last solution passed to the interim handler.
+            std::exception_ptr                           d_interim_exception;
+            std::atomic<bool>                            d_interim_failed{false};
+            std::atomic<int>                             d_winner{-1};
+            std::vector<Result>                          d_results;
+    };
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "ilp_solver_interface.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ilp_solver
+{
+    // One solver process of a portfolio race of ILPSolverStub (see create_solver_stub_portfolio).
+    // For hard MIPs, no single solver or random seed wins consistently, so the stub lets several racers solve the same ILP.
+    // Racers differ by their backend or by their parameters, e.g. "random_seed" for HiGHS or "Seed" for Gurobi.
+    struct PortfolioRacer
+    {
+        SolverBackend                                    backend{SolverBackend::DEFAULT};
+        std::vector<std::pair<std::string, std::string>> solver_parameters;   // Set after those of the stub.
+    };
+}
@@ -6,13 +6,22 @@
 #include "utility.hpp"
 
 #include <boost/chrono.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/nowide/convert.hpp>
 #include <chrono>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
+#ifdef _WIN32
 #include <windows.h> // for SetErrorMode
 #include <psapi.h> // GetProcessMemoryInfo
+#else
+#include <sys/resource.h> // getrusage
+#include <unistd.h> // getppid
+#endif
 
 #ifdef WITH_MIMALLOC
 
@@ -35,8 +44,9 @@ const inline int c_mimalloc_version = mi_version();
 
 using namespace ilp_solver;
 
-class ModelException  : public std::exception {};
-class SolverException : public std::exception {};
+class ModelException   : public std::exception {};
+class SolverException  : public std::exception {};
+class BackendException : public std::exception {};
 
 using ilp_solver::ScopedILPSolver;
 
@@ -52,47 +62,10 @@ constexpr auto c_test_exit_code
 //= SolverExitCode::missing_dll; // always results in error
 = SolverExitCode::forced_termination; // special case
 
-static void add_variables(ScopedILPSolver& v_solver, const ILPDataView& p_data)
-{
-    const auto num_variables = isize(p_data.variable_type);
-
-    for (auto variable_idx = 0; variable_idx < num_variables; ++variable_idx)
-    {
-        const auto lower = p_data.variable_lower[variable_idx];
-        const auto upper = p_data.variable_upper[variable_idx];
-        const auto variable_type = p_data.variable_type[variable_idx];
-        const auto objective = p_data.objective[variable_idx];
-
-        if (variable_type == VariableType::INTEGER)
-            v_solver->add_variable_integer(objective, lower, upper);
-        else if (variable_type == VariableType::BINARY)
-            v_solver->add_variable_boolean(objective);
-        else
-            v_solver->add_variable_continuous(objective, lower, upper);
-    }
-}
-
-
-static void add_constraints(ScopedILPSolver& v_solver, const ILPDataView& p_data)
-{
-    const auto num_constraints = isize(p_data.matrix.d_values);
-
-    for (auto i = 0; i < num_constraints; ++i)
-    {
-        const auto& values  = p_data.matrix.d_values [i];
-        const auto& indices = p_data.matrix.d_indices[i];
-        const auto  lower   = p_data.constraint_lower[i];
-        const auto  upper   = p_data.constraint_upper[i];
-
-        v_solver->add_constraint(indices, values, lower, upper);
-    }
-}
-
-
+// The data is already in the layout of the bulk interface, so the solver can take it without copying row by row.
 static void generate_ilp(ScopedILPSolver& v_solver, const ILPDataView& p_data)
 {
-    add_variables  (v_solver, p_data);
-    add_constraints(v_solver, p_data);
+    v_solver->load_model(p_data);
 }
 
 
@@ -116,6 +89,16 @@ static void set_solver_parameters(ScopedILPSolver& v_solver, const ILPDataView&
     v_solver->set_max_abs_gap       (p_data.max_abs_gap);
     v_solver->set_max_rel_gap       (p_data.max_rel_gap);
     v_solver->set_cutoff            (p_data.cutoff);
+
+    v_solver->set_interim_policy    (p_data.interim_policy);
+}
+
+
+// After the generic parameters, such that these can overwrite them.
+static void set_backend_parameters(ScopedILPSolver& v_solver, const ILPDataView& p_data)
+{
+    for_each_solver_parameter(p_data.solver_parameters, [&v_solver](const std::string& p_name, const std::string& p_value)
+                              { v_solver->set_solver_parameter(p_name, p_value); });
 }
 
 
@@ -129,11 +112,18 @@ static void solve_ilp(ScopedILPSolver& v_solver, ObjectiveSense p_objective_sens
 
 
 // Returns peak memory usage in megabytes.
+// This is the peak since the process has started, i.e., for a worker over all jobs it has solved so far.
 static double peak_memory_usage()
 {
+#ifdef _WIN32
     PROCESS_MEMORY_COUNTERS memory;
     if (GetProcessMemoryInfo(GetCurrentProcess(), &memory, sizeof(memory)))
         return static_cast<unsigned long long>(memory.PeakWorkingSetSize) * 0x1p-20;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        return static_cast<double>(usage.ru_maxrss) * 0x1p-10; // Peak resident set size in kilobytes on Linux.
+#endif
     return 0.;
 }
 
@@ -154,26 +144,39 @@ static ILPSolutionData solution_data(const ScopedILPSolver& p_solver, UserClock:
 
 
 // Throws ModelException, InvalidStartSolutionException, SolverException or std::bad_alloc
-static ILPSolutionData solve_ilp(const ILPDataView& p_data, CommunicationChild& p_communicator)
+static ILPSolutionData solve_ilp(ScopedILPSolver p_solver, const ILPDataView& p_data, CommunicationChild& p_communicator)
 {
     const auto start_time = UserClock::now();
-    auto       solver     = std::get<0>(all_solvers[1])();
+    auto       solver     = std::move(p_solver);
 
     try
     {
         generate_ilp(solver, p_data);
         set_solver_preparation_parameters(solver, p_data);
         set_solver_parameters(solver, p_data);
-        solver->set_interim_results([&p_communicator](ILPSolutionData* p_solution) -> void
+        try         { set_backend_parameters(solver, p_data); }
+        catch (...) { throw BackendException(); }
+        // The stub watches the heartbeats and the progress to decide whether to wait for us (see WatchdogPolicy).
+        solver->set_stop_condition([&p_communicator]()
         {
+            p_communicator.write_heartbeat();
+            return p_communicator.stop_requested();
+        });
+        solver->set_progress_handler([&p_communicator](const SolverProgress& p_progress) { p_communicator.write_progress(p_progress); });
+        // Save interim results in case the solver crashes. The stub may also pass them on while we are solving.
+        solver->set_interim_results([&p_communicator, start_time](ILPSolutionData* p_solution) -> void
+        {
+            p_solution->peak_memory  = peak_memory_usage();
+            p_solution->cpu_time_sec = Seconds(UserClock::now() - start_time).count();
             p_communicator.write_solution_data(*p_solution);
-        }); // Save interim results in case the solver crashes.
+        });
         // If the solver never finds a solution better than the start solution, above callback is never called.
         // So, we manually ensure that at least the start solution is communicated back to the calling process.
         p_communicator.write_solution_data(solution_data(solver, start_time));
     }
     catch (const std::bad_alloc&)                { throw; }
     catch (const InvalidStartSolutionException&) { throw; }
+    catch (const BackendException&)              { throw; }
     catch (...)                                  { throw ModelException(); }
 
     try
@@ -186,7 +189,9 @@ static ILPSolutionData solve_ilp(const ILPDataView& p_data, CommunicationChild&
 }
 
 
-static SolverExitCode solve_ilp(const std::string& p_shared_memory_name)
+// p_solver may be null or of another backend than *v_backend, then the solver is created here.
+// Sets *v_backend to the backend the ILP asks for.
+static SolverExitCode solve_ilp(const std::string& p_shared_memory_name, ScopedILPSolver p_solver, SolverBackend* v_backend)
 {
     try
     {
@@ -194,6 +199,14 @@ static SolverExitCode solve_ilp(const std::string& p_shared_memory_name)
         CommunicationChild communicator(p_shared_memory_name);
         auto               data = communicator.read_ilp_data();
 
+        if (!p_solver || data.backend != *v_backend)
+        {
+            *v_backend = data.backend;
+            p_solver   = create_solver(data.backend);
+            if (!p_solver)
+                throw BackendException();
+        }
+
         // test behavior of Caller when ScaiIlpExe crashes
         constexpr auto c_size_of_stub_tester = 2;
         if constexpr (c_test_crash != 0 && c_test_exit_code != SolverExitCode::forced_termination)
@@ -205,7 +218,7 @@ static SolverExitCode solve_ilp(const std::string& p_shared_memory_name)
         }
 
         // do the computation
-        communicator.write_solution_data(solve_ilp(data, communicator));
+        communicator.write_solution_data(solve_ilp(std::move(p_solver), data, communicator));
 
         // test timeouts
         if constexpr (c_test_crash != 0 && c_test_exit_code == SolverExitCode::forced_termination)
@@ -222,21 +235,136 @@ static SolverExitCode solve_ilp(const std::string& p_shared_memory_name)
     catch (const InvalidStartSolutionException&) { return SolverExitCode::invalid_start_solution; }
     catch (const ModelException&)                { return SolverExitCode::model_error;            }
     catch (const SolverException&)               { return SolverExitCode::solver_error;           }
+    catch (const BackendException&)              { return SolverExitCode::backend_error;          }
     catch (...)                                  { return SolverExitCode::shared_memory_error;    }
 }
 
 
+// How often an idle worker checks whether its parent is still running.
+constexpr auto c_parent_check_interval = std::chrono::seconds(1);
+
+
+// Tells whether the parent of a worker is still running.
+// On Windows, the parent is opened right away, such that its process id can not be reused while we watch it.
+// Elsewhere, a worker whose parent has ended gets another parent process.
+class ParentProcess
+{
+public:
+    explicit ParentProcess(std::uint64_t p_process_id)
+#ifdef _WIN32
+        : d_handle(OpenProcess(SYNCHRONIZE, FALSE, static_cast<DWORD>(p_process_id)))
+#else
+        : d_process_id(static_cast<pid_t>(p_process_id))
+#endif
+    {}
+
+    ParentProcess(const ParentProcess&)            = delete;
+    ParentProcess& operator=(const ParentProcess&) = delete;
+
+#ifdef _WIN32
+    ~ParentProcess()
+    {
+        if (d_handle != nullptr)
+            CloseHandle(d_handle);
+    }
+
+    bool is_running() const { return d_handle != nullptr && WaitForSingleObject(d_handle, 0) == WAIT_TIMEOUT; }
+
+private:
+    const HANDLE d_handle;
+#else
+    bool is_running() const { return getppid() == d_process_id; }
+
+private:
+    const pid_t d_process_id;
+#endif
+};
+
+
+// Solves one job after the other, as posted by WorkerPool to the WorkerSlot in p_slot_name.
+// The solver for the next job is created while waiting for it, so this overlaps with the parent building the model.
+// It is of the backend of the last job, assuming that the next one asks for the same.
+static SolverExitCode run_worker(const std::string& p_slot_name)
+{
+    try
+    {
+        namespace ip = boost::interprocess;
+        const SharedMemory      shared_memory(ip::open_only, p_slot_name.c_str(), ip::read_write);
+        const ip::mapped_region mapped_region(shared_memory, ip::read_write);
+        auto&                   slot = *static_cast<WorkerSlot*>(mapped_region.get_address());
+        const ParentProcess     parent(slot.parent_process_id);
+        auto                    backend = SolverBackend::DEFAULT;
+
+        while (true)
+        {
+            // If creating fails, solve_ilp tries again and reports the error.
+            ScopedILPSolver solver;
+            try         { solver = create_solver(backend); }
+            catch (...) {}
+
+            // If the parent has ended without shutting us down, nobody will post a job anymore.
+            // On POSIX, the name of the slot would also remain in /dev/shm, since its creator has not removed it.
+            const auto check_interval = boost::posix_time::seconds(c_parent_check_interval.count());
+            while (!slot.job_posted.timed_wait(boost::posix_time::microsec_clock::universal_time() + check_interval))
+            {
+                if (!parent.is_running())
+                {
+#ifndef _WIN32
+                    ip::shared_memory_object::remove(p_slot_name.c_str());
+#endif
+                    return SolverExitCode::ok;
+                }
+            }
+            if (slot.shutdown)
+                return SolverExitCode::ok;
+
+            slot.shared_memory_name[WorkerSlot::c_max_name_size - 1] = '\0';
+            slot.exit_code = solve_ilp(std::string(slot.shared_memory_name), std::move(solver), &backend);
+            slot.job_done.post();
+        }
+    }
+    catch (...) { return SolverExitCode::shared_memory_error; }
+}
+
+
+// Command line: <shared memory name> to solve one ILP, or --worker <slot name> to solve ILPs until shut down.
+static SolverExitCode run(const std::vector<std::string>& p_arguments)
+{
+    if (p_arguments.size() == 1)
+    {
+        auto backend = SolverBackend::DEFAULT;
+        return solve_ilp(p_arguments[0], nullptr, &backend);
+    }
+    if (p_arguments.size() == 2 && p_arguments[0] == "--worker")
+        return run_worker(p_arguments[1]);
+    return SolverExitCode::command_line_error;
+}
+
+
+#ifdef _WIN32
 SolverExitCode my_main(int argc, wchar_t* argv[])
 {
     SetErrorMode(SEM_FAILCRITICALERRORS | SEM_NOGPFAULTERRORBOX);
-    if (argc != 2)
-        return SolverExitCode::command_line_error;
-    const auto shared_memory_name = std::wstring(argv[1]);
-    return solve_ilp(boost::nowide::narrow(shared_memory_name));
+    std::vector<std::string> arguments;
+    for (auto i = 1; i < argc; ++i)
+        arguments.push_back(boost::nowide::narrow(std::wstring(argv[i])));
+    return run(arguments);
 }
 
 
 int wmain(int argc, wchar_t* argv[])
 {
-    return static_cast<int>(my_main (argc, argv));
+    return to_process_exit_code(my_main (argc, argv));
 }
+#else
+SolverExitCode my_main(int argc, char* argv[])
+{
+    return run(std::vector<std::string>(argv + 1, argv + argc));
+}
+
+
+int main(int argc, char* argv[])
+{
+    return to_process_exit_code(my_main (argc, argv));
+}
+#endif
@@ -5,12 +5,37 @@
 #include <boost/utility.hpp>
 #include <type_traits>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <span>
 #include <vector>
 
 template<typename T>
 concept POD = std::is_pod_v<T>;
 
+
+// PADDED:  Every value and every array is padded to a multiple of sizeof(std::max_align_t).
+// COMPACT: Values are stored with their natural alignment, and only the start of each array
+//          is aligned to alignof(std::max_align_t).
+// Both sides must use the same layout. The start address must be aligned to alignof(std::max_align_t).
+enum class SerializationLayout { PADDED, COMPACT };
+
+
+// May be written in front of serialized data to check that both sides agree on the format.
+// Kept without member initializers, such that it can be serialized as POD.
+struct SerializationHeader
+{
+    static constexpr std::uint32_t c_magic   = 0x504C4953; // "SILP"
+    static constexpr std::uint32_t c_version = 8;          // Increase whenever the serialized data changes.
+
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t total_size;   // Number of bytes of the serialized data, including the header.
+
+    static SerializationHeader create(std::uint64_t p_total_size) { return {c_magic, c_version, p_total_size}; }
+    bool is_valid() const { return magic == c_magic && version == c_version; }
+};
+
 /**********************************
 * Serializes plain old data types *
 * (POD types) and vectors         *
@@ -21,10 +46,11 @@ class Serializer
         // p_address == nullptr simulates serialization. This allows calculating
         // the amount of required bytes without writing the data to a temporary
         // memory location.
-        explicit Serializer(void* p_address)
+        explicit Serializer(void* p_address, SerializationLayout p_layout = SerializationLayout::PADDED)
             : d_start_address(static_cast<char*>(p_address)),
               d_current_address(static_cast<char*>(p_address)),
-              d_simulate(d_start_address == nullptr ? true : false)
+              d_simulate(d_start_address == nullptr ? true : false),
+              d_layout(p_layout)
             {}
 
         // copy constructor and assignment operator are not allowed (due to const members)
@@ -38,14 +64,15 @@ class Serializer
 
         void* current_address() const { return d_current_address; }
 
-        template<POD T>      void serialize(const T& p_value);
-        template<POD T>      void serialize(const std::vector<T>& p_vector);
-        template<typename T> void serialize(const std::vector<std::vector<T>>& p_vector_of_vectors);
+        template<POD T>                     void serialize(const T& p_value);
+        template<POD T, typename Allocator> void serialize(const std::vector<T, Allocator>& p_vector);
+        template<typename T>                void serialize(const std::vector<std::vector<T>>& p_vector_of_vectors);
 
     private:
         const char* d_start_address;
         char* d_current_address;
         const bool d_simulate;
+        const SerializationLayout d_layout;
 };
 
 
@@ -56,20 +83,47 @@ class Serializer
 class Deserializer
 {
     public:
-        explicit Deserializer(void* p_address) : d_current_address(static_cast<char*>(p_address)) {}
+        explicit Deserializer(void* p_address, SerializationLayout p_layout = SerializationLayout::PADDED)
+            : d_current_address(static_cast<char*>(p_address)), d_layout(p_layout) {}
 
         void* current_address() const { return d_current_address; }
 
         template<POD T>      void deserialize(T& r_value);
         template<POD T>      void deserialize(std::vector<T>& r_vector);
         template<POD T>      void deserialize(std::span<T>& r_span);
-        template<POD T>      void deserialize(std::vector<std::span<T>>& r_vector_of_spans);
         template<typename T> void deserialize(std::vector<std::vector<T>>& r_vector_of_vectors);
 
     private:
         char* d_current_address;
+        const SerializationLayout d_layout;
+};
+
+/*************************************************
+* Computes the number of bytes of a serialization *
+* from the types and the lengths of vectors only  *
+*************************************************/
+class SerializedSize
+{
+    public:
+        explicit SerializedSize(SerializationLayout p_layout = SerializationLayout::PADDED) : d_layout(p_layout) {}
+
+        // Adds the bytes which serialize(...) would write.
+        template<POD T> SerializedSize& add(const T&)                      { return add_value<T>(); }
+        template<POD T, typename Allocator>
+        SerializedSize& add(const std::vector<T, Allocator>& p_vector) { return add_vector<T>(isize(p_vector)); }
+
+        // Adds the bytes for a value or a vector of p_size elements that does not exist yet.
+        template<POD T> SerializedSize& add_value();
+        template<POD T> SerializedSize& add_vector(int p_size);
+
+        std::size_t required_bytes() const { return d_num_bytes; }
+
+    private:
+        std::size_t d_num_bytes{0};
+        const SerializationLayout d_layout;
 };
 
+
 /*****************************************************
 * Embedded DSL for serialization and deserialization *
 *****************************************************/
@@ -111,42 +165,125 @@ static_assert(num_bytes_with_padding(4) == sizeof(std::max_align_t));
 static_assert(num_bytes_with_padding(8) == sizeof(std::max_align_t));
 
 
+// Increases p_offset to the next multiple of p_alignment.
+constexpr std::size_t align_offset(std::size_t p_offset, std::size_t p_alignment)
+{
+    const auto misalignment = p_offset % p_alignment;
+    return misalignment == 0 ? p_offset : p_offset + (p_alignment - misalignment);
+}
+
+
+// Increases p_address to the next multiple of p_alignment.
+// The alignment is taken on absolute addresses, which is the same as relative to the start address
+// for real serialization and relative to nullptr for simulated serialization.
+inline char* align_address(char* p_address, std::size_t p_alignment)
+{
+    const auto address = reinterpret_cast<std::uintptr_t>(p_address);
+    return p_address + (align_offset(address, p_alignment) - address);
+}
+
+
+// Returns the offset where a value of type T starts, and the offset after it.
+// Offsets are relative to an address aligned to alignof(std::max_align_t).
+template<typename T>
+constexpr std::pair<std::size_t, std::size_t> value_offsets(std::size_t p_offset, SerializationLayout p_layout)
+{
+    if (p_layout == SerializationLayout::PADDED)
+        return {p_offset, p_offset + num_bytes_with_padding(sizeof(T))};
+
+    const auto start = align_offset(p_offset, alignof(T));
+    return {start, start + sizeof(T)};
+}
+
+
+// Returns the offset where an array of p_num_bytes bytes starts, and the offset after it.
+constexpr std::pair<std::size_t, std::size_t> array_offsets(std::size_t p_offset, std::size_t p_num_bytes, SerializationLayout p_layout)
+{
+    if (p_layout == SerializationLayout::PADDED)
+        return {p_offset, p_offset + num_bytes_with_padding(p_num_bytes)};
+
+    const auto start = align_offset(p_offset, alignof(std::max_align_t));
+    return {start, start + p_num_bytes};
+}
+
+
+// Returns the address where a value of type T starts, and the address after it.
+template<typename T>
+std::pair<char*, char*> value_bounds(char* p_address, SerializationLayout p_layout)
+{
+    const auto address      = reinterpret_cast<std::uintptr_t>(p_address);
+    const auto [start, end] = value_offsets<T>(address, p_layout);
+    return {p_address + (start - address), p_address + (end - address)};
+}
+
+
+// Returns the address where an array of p_num_bytes bytes starts, and the address after it.
+inline std::pair<char*, char*> array_bounds(char* p_address, std::size_t p_num_bytes, SerializationLayout p_layout)
+{
+    const auto address      = reinterpret_cast<std::uintptr_t>(p_address);
+    const auto [start, end] = array_offsets(address, p_num_bytes, p_layout);
+    return {p_address + (start - address), p_address + (end - address)};
+}
+
+
+// Size computation
+// ================
+// Counts the bytes from offset 0, which has the same alignment as the start address of a Serializer.
+template<POD T>
+SerializedSize& SerializedSize::add_value()
+{
+    d_num_bytes = value_offsets<T>(d_num_bytes, d_layout).second;
+    return *this;
+}
+
+
+template<POD T>
+SerializedSize& SerializedSize::add_vector(int p_size)
+{
+    add_value<int>();
+    const auto num_bytes = p_size*sizeof(T);
+    d_num_bytes = array_offsets(d_num_bytes, num_bytes, d_layout).second;
+    return *this;
+}
+
+
 // (De-) Serialization of a POD type
 // =================================
 template<POD T>
 void Serializer::serialize(const T& p_value)
 {
-    const auto num_bytes = sizeof(T);
+    const auto [start, end] = value_bounds<T>(d_current_address, d_layout);
     if (!d_simulate)
     {
-        auto address = static_cast<T*>(static_cast<void*>(d_current_address));
+        auto address = static_cast<T*>(static_cast<void*>(start));
         *address = p_value;
     }
-    d_current_address += num_bytes_with_padding(num_bytes);
+    d_current_address = end;
 }
 
 
 template<POD T>
 void Deserializer::deserialize(T& r_value)
 {
-    const auto num_bytes = sizeof(T);
-    auto address = static_cast<T*>(static_cast<void*>(d_current_address));
+    const auto [start, end] = value_bounds<T>(d_current_address, d_layout);
+    auto address = static_cast<T*>(static_cast<void*>(start));
     r_value = *address;
-    d_current_address += num_bytes_with_padding(num_bytes);
+    d_current_address = end;
 }
 
 
 // (De-) Serialization of a POD type vector
 // ========================================
-template<POD T>
-void Serializer::serialize(const std::vector<T>& p_vector)
+template<POD T, typename Allocator>
+void Serializer::serialize(const std::vector<T, Allocator>& p_vector)
 {
     const auto size = isize(p_vector);
     serialize(size);
     const auto num_bytes = size*sizeof(T);
+    const auto [start, end] = array_bounds(d_current_address, num_bytes, d_layout);
     if (!d_simulate)
-        std::memcpy(d_current_address, p_vector.data(), num_bytes);
-    d_current_address += num_bytes_with_padding(num_bytes);
+        std::memcpy(start, p_vector.data(), num_bytes);
+    d_current_address = end;
 }
 
 
@@ -156,9 +293,10 @@ void Deserializer::deserialize(std::vector<T>& r_vector)
     int size;
     deserialize(size);
     const auto num_bytes = size*sizeof(T);
+    const auto [start, end] = array_bounds(d_current_address, num_bytes, d_layout);
     r_vector.resize(size);
-    std::memcpy(r_vector.data(), d_current_address, num_bytes);
-    d_current_address += num_bytes_with_padding(num_bytes);
+    std::memcpy(r_vector.data(), start, num_bytes);
+    d_current_address = end;
 }
 
 
@@ -168,9 +306,9 @@ void Deserializer::deserialize(std::span<T>& r_span)
     int size;
     deserialize(size);
     const auto num_bytes = size*sizeof(T);
-    const auto start     = static_cast<T*>(static_cast<void*>(d_current_address));
-    r_span               = std::span<T>(start, size);
-    d_current_address += num_bytes_with_padding(num_bytes);
+    const auto [start, end] = array_bounds(d_current_address, num_bytes, d_layout);
+    r_span = std::span<T>(static_cast<T*>(static_cast<void*>(start)), size);
+    d_current_address = end;
 }
 
 
@@ -196,13 +334,3 @@ void Deserializer::deserialize(std::vector<std::vector<T>>& r_vector_of_vectors)
         deserialize(vector);
 }
 
-
-template<POD T>
-void Deserializer::deserialize(std::vector<std::span<T>>& r_vector_of_spans)
-{
-    int size;
-    deserialize(size);
-    r_vector_of_spans = std::vector<std::span<T>>(size);
-    for (auto& span : r_vector_of_spans)
-        deserialize(span);
-}
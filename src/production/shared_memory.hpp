@@ -0,0 +1,71 @@
+#pragma once
+
+#ifdef _WIN32
+#include <boost/interprocess/windows_shared_memory.hpp>
+#else
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <cstddef>
+#endif
+
+
+namespace ilp_solver
+{
+
+#ifdef _WIN32
+
+// Named shared memory that exists as long as any process has it opened or mapped.
+using SharedMemory = boost::interprocess::windows_shared_memory;
+
+#else
+
+// Named POSIX shared memory (shm_open) with the same interface as boost::interprocess::windows_shared_memory.
+// The name is removed when the creator closes it, which is the part of the Windows lifetime we rely on:
+// The creator keeps it open until the other process has finished, and mappings stay valid after removal.
+// If the creator crashes before, the name remains in /dev/shm and is skipped by create_shared_memory_segment.
+// Thus, the creator should call remove_name as soon as the other process has opened the memory.
+class SharedMemory
+{
+public:
+    SharedMemory(boost::interprocess::create_only_t, const char* p_name, boost::interprocess::mode_t p_mode, std::size_t p_size)
+        : d_shared_memory(boost::interprocess::create_only, p_name, p_mode), d_owns_name(true)
+    {
+        try
+        {
+            d_shared_memory.truncate(static_cast<boost::interprocess::offset_t>(p_size));
+        }
+        catch (...)
+        {
+            boost::interprocess::shared_memory_object::remove(p_name);
+            throw;
+        }
+    }
+
+    SharedMemory(boost::interprocess::open_only_t, const char* p_name, boost::interprocess::mode_t p_mode)
+        : d_shared_memory(boost::interprocess::open_only, p_name, p_mode), d_owns_name(false)
+    {}
+
+    SharedMemory(const SharedMemory&)            = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    ~SharedMemory() { remove_name(); }
+
+    // Removes the name if this is the creator. The memory then can no longer be opened, but stays mapped.
+    void remove_name()
+    {
+        if (d_owns_name)
+            boost::interprocess::shared_memory_object::remove(d_shared_memory.get_name());
+        d_owns_name = false;
+    }
+
+    // Needed by boost::interprocess::mapped_region.
+    boost::interprocess::mapping_handle_t get_mapping_handle() const { return d_shared_memory.get_mapping_handle(); }
+    boost::interprocess::mode_t           get_mode()           const { return d_shared_memory.get_mode(); }
+
+private:
+    boost::interprocess::shared_memory_object d_shared_memory;
+    bool                                      d_owns_name;
+};
+
+#endif
+
+} // namespace ilp_solver
@@ -0,0 +1,65 @@
+#include "shared_memory_arena.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+
+namespace ip = boost::interprocess;
+
+constexpr auto c_shared_memory_base_name = "ScaiIlpSolver";
+constexpr auto c_num_shared_memory_name_trials = 10000;
+
+namespace ilp_solver
+{
+
+std::unique_ptr<SharedMemory> create_shared_memory_segment(std::size_t p_size, std::string* r_name)
+{
+    for (auto trial = 1; trial <= c_num_shared_memory_name_trials; ++trial)
+    {
+        *r_name = c_shared_memory_base_name + std::to_string(trial);
+        try
+        {
+            return std::make_unique<SharedMemory>(ip::create_only, r_name->c_str(), ip::read_write, p_size);
+        }
+        catch (const ip::interprocess_exception& p_e)
+        {
+            if (p_e.get_error_code() != ip::error_code_t::already_exists_error || trial == c_num_shared_memory_name_trials)
+                throw;
+        }
+    }
+    return {};
+}
+
+
+std::string SharedMemoryArena::segment_name(const void* p_address) const
+{
+    const auto segment = d_segments.find(p_address);
+    return segment == d_segments.end() ? std::string() : segment->second.name;
+}
+
+
+void* SharedMemoryArena::do_allocate(std::size_t p_bytes, std::size_t p_alignment)
+{
+    if (p_bytes < c_min_segment_bytes)
+        return d_upstream->allocate(p_bytes, p_alignment);
+
+    Segment segment;
+    segment.shared_memory = create_shared_memory_segment(p_bytes, &segment.name);
+    segment.mapped_region = std::make_unique<ip::mapped_region>(*segment.shared_memory, ip::read_write);
+
+    auto address = segment.mapped_region->get_address();
+    assert(reinterpret_cast<std::uintptr_t>(address) % p_alignment == 0); // Regions start at page boundaries.
+    d_segments.emplace(address, std::move(segment));
+    return address;
+}
+
+
+void SharedMemoryArena::do_deallocate(void* p_address, std::size_t p_bytes, std::size_t p_alignment)
+{
+    if (p_bytes < c_min_segment_bytes)
+        d_upstream->deallocate(p_address, p_bytes, p_alignment);
+    else
+        d_segments.erase(p_address);
+}
+
+} // namespace ilp_solver
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "shared_memory.hpp"
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+
+
+namespace ilp_solver
+{
+
+// Creates a shared memory segment of p_size bytes with a name that is not in use yet.
+std::unique_ptr<SharedMemory> create_shared_memory_segment(std::size_t p_size, std::string* r_name);
+
+
+// Memory resource for the arrays of ILPData in ILPSolverStub.
+// Each allocation of at least c_min_segment_bytes gets a shared memory segment of its own,
+// such that only its name needs to be passed to the solver process, which maps the array as it is.
+// Smaller allocations are taken from the upstream resource and are copied to the solver process.
+// A segment is destroyed on deallocation, so a growing vector holds at most two segments at a time.
+// Not thread-safe, like the vectors using it.
+class SharedMemoryArena final : public std::pmr::memory_resource
+{
+public:
+    static constexpr std::size_t c_min_segment_bytes = 1 << 20;
+
+    explicit SharedMemoryArena(std::pmr::memory_resource* p_upstream = std::pmr::new_delete_resource())
+        : d_upstream(p_upstream) {}
+
+    SharedMemoryArena(const SharedMemoryArena&)            = delete;
+    SharedMemoryArena& operator=(const SharedMemoryArena&) = delete;
+
+    // Returns the name of the segment starting at p_address,
+    // or an empty string if p_address has not been allocated in a segment of its own.
+    std::string segment_name(const void* p_address) const;
+
+private:
+    struct Segment
+    {
+        std::string                                         name;
+        std::unique_ptr<SharedMemory>                       shared_memory;
+        std::unique_ptr<boost::interprocess::mapped_region> mapped_region;
+    };
+
+    std::pmr::memory_resource* const          d_upstream;
+    std::unordered_map<const void*, Segment> d_segments;
+
+    void* do_allocate(std::size_t p_bytes, std::size_t p_alignment) override;
+    void  do_deallocate(void* p_address, std::size_t p_bytes, std::size_t p_alignment) override;
+    bool  do_is_equal(const std::pmr::memory_resource& p_other) const noexcept override { return this == &p_other; }
+};
+
+} // namespace ilp_solver
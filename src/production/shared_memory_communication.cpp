@@ -1,12 +1,21 @@
 #include "shared_memory_communication.hpp"
 
 #include "serialization.hpp"
+#include "shared_memory_arena.hpp"
+
+#include <atomic>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
 
 
 namespace ip = boost::interprocess;
 
-constexpr auto c_shared_memory_base_name = "ScaiIlpSolver";
-constexpr auto c_num_shared_memory_name_trials = 10000;
+// Layout of all data in the shared memory. Parent and child must agree on it, which is checked by the header.
+constexpr auto c_layout = SerializationLayout::COMPACT;
 
 namespace ilp_solver
 {
@@ -36,23 +45,241 @@ static void deserialize_result(Deserializer* v_deserializer, ILPSolutionData* r_
 }
 
 
+// Must add the same values in the same order as serialize_result.
+static SerializedSize& add_result(SerializedSize* v_size, int p_num_variables, int p_num_constraints)
+{
+    return v_size->add_value<SolutionStatus>()                      // solution_status
+                  .add_value<double>()                              // objective
+                  .add_vector<double>(p_num_variables)              // solution
+                  .add_vector<double>(p_num_constraints)            // dual_sol
+                  .add_value<double>()                              // cpu_time_sec
+                  .add_value<double>();                             // peak_memory
+}
+
+
+/*******************************
+* Double-buffered result slot *
+*******************************/
+// The child may be killed at any time, also while it writes a solution.
+// Therefore, it writes each solution to the buffer that does not hold the last committed one,
+// and commits it afterwards by a single atomic store to num_commits.
+// The last committed solution is in buffer(num_commits), the initial one written by the parent in buffer(0).
+// A reader running concurrently with the writer copies the buffer
+// and retries if num_commits has changed meanwhile (seqlock).
+// Each commit posts solution_posted, such that a reader can sleep until the next one.
+// Only the child writes the solutions after the parent has created the slot.
+// The parent sets stop_requested to ask the child to stop solving and write its best solution.
+// The child counts num_heartbeats up and stores the progress of its solver, such that the parent can watch it.
+struct ResultSlot
+{
+    static constexpr int c_num_buffers = 2;
+
+    std::atomic<std::uint64_t>                  num_commits;
+    std::uint64_t                               buffer_size;    // Bytes of each buffer, a multiple of sizeof(std::max_align_t).
+    boost::interprocess::interprocess_semaphore solution_posted{0};
+    std::atomic<bool>                           stop_requested{false};
+    std::atomic<std::uint64_t>                  num_heartbeats{0};
+    std::atomic<long long>                      num_nodes{0};
+    std::atomic<double>                         best_bound{c_neg_inf};
+    std::atomic<bool>                           data_read{false};   // The child has opened all segments of the ILP.
+
+    static std::size_t header_size()                            { return num_bytes_with_padding(sizeof(ResultSlot)); }
+    static std::size_t required_bytes(std::size_t p_buffer_size) { return header_size() + c_num_buffers*p_buffer_size; }
+
+    char* buffer(std::uint64_t p_num_commits)
+    {
+        return reinterpret_cast<char*>(this) + header_size() + (p_num_commits % c_num_buffers)*buffer_size;
+    }
+};
+
+// The atomics are shared between processes, which only works if they are lock-free.
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+static_assert(std::atomic<bool>::is_always_lock_free);
+static_assert(std::atomic<long long>::is_always_lock_free);
+static_assert(std::atomic<double>::is_always_lock_free);
+
+
+// Buffers start at multiples of alignof(std::max_align_t) like a SerializedSize, so the size computed here fits.
+static std::size_t result_buffer_size(int p_num_variables, int p_num_constraints)
+{
+    SerializedSize size(c_layout);
+    return num_bytes_with_padding(add_result(&size, p_num_variables, p_num_constraints).required_bytes());
+}
+
+
+// The slot is placed at the first suitably aligned address at or after p_address.
+static ResultSlot* result_slot_address(void* p_address)
+{
+    return reinterpret_cast<ResultSlot*>(align_address(static_cast<char*>(p_address), alignof(std::max_align_t)));
+}
+
+
+static ResultSlot* create_result_slot(void* p_address, std::size_t p_buffer_size, const ILPSolutionData& p_initial_solution)
+{
+    auto slot = new (result_slot_address(p_address)) ResultSlot{{0}, p_buffer_size};
+    Serializer serializer(slot->buffer(0), c_layout);
+    serialize_result(&serializer, p_initial_solution);
+    return slot;
+}
+
+
+static void write_result(ResultSlot* v_slot, const ILPSolutionData& p_solution_data)
+{
+    SerializedSize size(c_layout);
+    if (add_result(&size, isize(p_solution_data.solution), isize(p_solution_data.dual_sol)).required_bytes() > v_slot->buffer_size)
+        throw std::runtime_error("Solution does not fit into the shared memory reserved for it.");
+
+    const auto num_commits = v_slot->num_commits.load(std::memory_order_relaxed);
+    // Keeps the writes below from becoming visible before the previous commit, which a concurrent reader relies on.
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Serializer serializer(v_slot->buffer(num_commits + 1), c_layout);
+    serialize_result(&serializer, p_solution_data);
+    v_slot->num_commits.store(num_commits + 1, std::memory_order_release);
+    v_slot->solution_posted.post();
+}
+
+
+// Returns the number of commits up to the solution read.
+static std::uint64_t read_result(ResultSlot* p_slot, ILPSolutionData* r_solution_data)
+{
+    std::vector<std::max_align_t> copy(p_slot->buffer_size / sizeof(std::max_align_t));
+    std::uint64_t                 num_commits;
+    while (true)
+    {
+        num_commits = p_slot->num_commits.load(std::memory_order_acquire);
+        std::memcpy(copy.data(), p_slot->buffer(num_commits), p_slot->buffer_size);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (p_slot->num_commits.load(std::memory_order_relaxed) == num_commits)
+            break;
+    }
+
+    Deserializer deserializer(copy.data(), c_layout);
+    deserialize_result(&deserializer, r_solution_data);
+    return num_commits;
+}
+
+
+// Returns whether a solution has been committed after the first p_num_commits ones, waiting at most until p_deadline.
+static bool wait_for_result(ResultSlot* p_slot, std::uint64_t p_num_commits, const boost::posix_time::ptime& p_deadline)
+{
+    // Posts of solutions that have been read already make the loop run once more, but do not end it early.
+    while (p_slot->num_commits.load(std::memory_order_acquire) == p_num_commits)
+    {
+        if (!p_slot->solution_posted.timed_wait(p_deadline))
+            return p_slot->num_commits.load(std::memory_order_acquire) != p_num_commits;
+    }
+    return true;
+}
+
+
+/******************************************************
+* (De-) Serialization of arrays that may be allocated *
+* in shared memory segments of their own              *
+******************************************************/
+constexpr auto c_max_segment_name_size = 64;
+
+// Precedes each array of the ILP data.
+// If the array lies in a segment of a SharedMemoryArena, only the segment name and the array size follow.
+// Otherwise, the segment name is empty and the array follows as usual.
+struct ArrayLocation
+{
+    char segment_name[c_max_segment_name_size];
+
+    bool is_inline() const { return segment_name[0] == '\0'; }
+};
+
+
+template<typename T>
+static ArrayLocation array_location(const std::pmr::vector<T>& p_vector)
+{
+    ArrayLocation location{};
+    const auto    arena = dynamic_cast<const SharedMemoryArena*>(p_vector.get_allocator().resource());
+    if (arena != nullptr && !p_vector.empty())
+    {
+        const auto name = arena->segment_name(p_vector.data());
+        assert(isize(name) < c_max_segment_name_size);
+        name.copy(location.segment_name, name.size());
+    }
+    return location;
+}
+
+
+template<typename T>
+static void add_array(SerializedSize* v_size, const std::pmr::vector<T>& p_vector)
+{
+    const auto location = array_location(p_vector);
+    v_size->add(location);
+    if (location.is_inline())
+        v_size->add(p_vector);
+    else
+        v_size->add(isize(p_vector));
+}
+
+
+template<typename T>
+static void serialize_array(Serializer* v_serializer, const std::pmr::vector<T>& p_vector)
+{
+    const auto location = array_location(p_vector);
+    *v_serializer << location;
+    if (location.is_inline())
+        *v_serializer << p_vector;
+    else
+        *v_serializer << isize(p_vector);
+}
+
+
+// Maps the segments of arrays that are not inline to v_regions, which must live as long as r_span is used.
+// They are mapped read-only, because the segments of a stub are shared by all processes solving its ILP (see PortfolioRacer).
+template<typename T>
+static void deserialize_array(Deserializer* v_deserializer, std::span<T>* r_span,
+                              std::vector<std::unique_ptr<ip::mapped_region>>* v_regions)
+{
+    ArrayLocation location{};
+    *v_deserializer >> location;
+    if (location.is_inline())
+    {
+        *v_deserializer >> *r_span;
+        return;
+    }
+
+    location.segment_name[c_max_segment_name_size - 1] = '\0';
+    int size;
+    *v_deserializer >> size;
+
+    const SharedMemory shared_memory(ip::open_only, location.segment_name, ip::read_only);
+    auto& region = v_regions->emplace_back(std::make_unique<ip::mapped_region>(shared_memory, ip::read_only));
+    if (size < 0 || region->get_size() < size * sizeof(T))
+        throw std::runtime_error("Shared memory segment is smaller than the array stored in it.");
+    *r_span = std::span<T>(static_cast<T*>(region->get_address()), size);
+}
+
+
 /**********************************
 * (De-) Serialization of ILP data *
 **********************************/
-static void* serialize_ilp_data(Serializer* v_serializer, const ILPData& p_data, const ILPSolutionData& p_solution_data)
-{
-    *v_serializer   << p_data.matrix.d_values
-                    << p_data.matrix.d_indices
-                    << p_data.matrix.d_num_cols
-                    << p_data.objective
-                    << p_data.variable_lower
-                    << p_data.variable_upper
-                    << p_data.constraint_lower
-                    << p_data.constraint_upper
-                    << p_data.variable_type
-                    << p_data.objective_sense
-                    << p_data.start_solution
-                    << p_data.num_threads
+// Returns the address after the ILP data.
+static void* serialize_ilp_data(Serializer* v_serializer, const SerializationHeader& p_header, const ILPData& p_data)
+{
+    assert(p_data.matrix.d_column_entries.empty()); // Call ILPData::Matrix::flush() before.
+
+    // The solver comes first, such that the child knows which one to use before it reads the model.
+    *v_serializer << p_header << p_data.backend;
+    serialize_array(v_serializer, p_data.solver_parameters);
+    serialize_array(v_serializer, p_data.matrix.d_row_starts);
+    serialize_array(v_serializer, p_data.matrix.d_indices);
+    serialize_array(v_serializer, p_data.matrix.d_values);
+    *v_serializer << p_data.matrix.d_num_cols;
+    serialize_array(v_serializer, p_data.objective);
+    serialize_array(v_serializer, p_data.variable_lower);
+    serialize_array(v_serializer, p_data.variable_upper);
+    serialize_array(v_serializer, p_data.constraint_lower);
+    serialize_array(v_serializer, p_data.constraint_upper);
+    serialize_array(v_serializer, p_data.variable_type);
+    *v_serializer << p_data.objective_sense;
+    serialize_array(v_serializer, p_data.start_solution);
+
+    *v_serializer   << p_data.num_threads
                     << p_data.deterministic
                     << p_data.log_level
                     << p_data.presolve
@@ -61,94 +288,115 @@ static void* serialize_ilp_data(Serializer* v_serializer, const ILPData& p_data,
                     << p_data.max_solutions
                     << p_data.max_abs_gap
                     << p_data.max_rel_gap
-                    << p_data.cutoff;
+                    << p_data.cutoff
+                    << p_data.interim_policy.min_interval_seconds
+                    << p_data.interim_policy.min_relative_improvement
+                    << p_data.interim_policy.coalesce;
 
-    auto result_address = v_serializer->current_address();
-    serialize_result(v_serializer, p_solution_data);
-    return result_address;
+    return v_serializer->current_address();
 }
 
 
-static void* deserialize_ilp_data(Deserializer& v_deserializer, ILPDataView& r_data)
+// Returns the address after the ILP data.
+static void* deserialize_ilp_data(Deserializer* v_deserializer, ILPDataView* r_data, std::size_t p_available_bytes,
+                                  std::vector<std::unique_ptr<ip::mapped_region>>* v_regions)
 {
-    v_deserializer  >> r_data.matrix.d_values
-                    >> r_data.matrix.d_indices
-                    >> r_data.matrix.d_num_cols
-                    >> r_data.objective
-                    >> r_data.variable_lower
-                    >> r_data.variable_upper
-                    >> r_data.constraint_lower
-                    >> r_data.constraint_upper
-                    >> r_data.variable_type
-                    >> r_data.objective_sense
-                    >> r_data.start_solution
-                    >> r_data.num_threads
-                    >> r_data.deterministic
-                    >> r_data.log_level
-                    >> r_data.presolve
-                    >> r_data.max_seconds
-                    >> r_data.max_nodes
-                    >> r_data.max_solutions
-                    >> r_data.max_abs_gap
-                    >> r_data.max_rel_gap
-                    >> r_data.cutoff;
-
-    return v_deserializer.current_address();
-}
-
-
-// To reserve space for the solution in the shared memory
-static ILPSolutionData dummy_solution(const ILPData& p_data)
-{
-    ILPSolutionData dummy_solution_data(p_data.objective_sense);
-    dummy_solution_data.solution.resize(p_data.matrix.d_num_cols);
-    dummy_solution_data.dual_sol.resize(p_data.matrix.d_values.size());
-    return dummy_solution_data;
+    SerializationHeader header{};
+    *v_deserializer >> header;
+    if (!header.is_valid())
+        throw std::runtime_error("Shared memory does not contain ILP data of a compatible version.");
+    if (header.total_size > p_available_bytes)
+        throw std::runtime_error("Shared memory is smaller than the ILP data stored in it.");
+
+    *v_deserializer >> r_data->backend;
+    deserialize_array(v_deserializer, &r_data->solver_parameters, v_regions);
+    deserialize_array(v_deserializer, &r_data->matrix.d_row_starts, v_regions);
+    deserialize_array(v_deserializer, &r_data->matrix.d_indices, v_regions);
+    deserialize_array(v_deserializer, &r_data->matrix.d_values, v_regions);
+    *v_deserializer >> r_data->matrix.d_num_cols;
+    deserialize_array(v_deserializer, &r_data->objective, v_regions);
+    deserialize_array(v_deserializer, &r_data->variable_lower, v_regions);
+    deserialize_array(v_deserializer, &r_data->variable_upper, v_regions);
+    deserialize_array(v_deserializer, &r_data->constraint_lower, v_regions);
+    deserialize_array(v_deserializer, &r_data->constraint_upper, v_regions);
+    deserialize_array(v_deserializer, &r_data->variable_type, v_regions);
+    *v_deserializer >> r_data->objective_sense;
+    deserialize_array(v_deserializer, &r_data->start_solution, v_regions);
+
+    *v_deserializer >> r_data->num_threads
+                    >> r_data->deterministic
+                    >> r_data->log_level
+                    >> r_data->presolve
+                    >> r_data->max_seconds
+                    >> r_data->max_nodes
+                    >> r_data->max_solutions
+                    >> r_data->max_abs_gap
+                    >> r_data->max_rel_gap
+                    >> r_data->cutoff
+                    >> r_data->interim_policy.min_interval_seconds
+                    >> r_data->interim_policy.min_relative_improvement
+                    >> r_data->interim_policy.coalesce;
+
+    return v_deserializer->current_address();
 }
 
 
+// Must add the same values in the same order as serialize_ilp_data.
+// The result slot behind the ILP data has room for two full solutions.
 static std::size_t determine_required_size(const ILPData& p_data)
 {
-    Serializer serializer(nullptr);
-    serialize_ilp_data(&serializer, p_data, dummy_solution(p_data));
-    return serializer.required_bytes();
+    SerializedSize size(c_layout);
+    size.add_value<SerializationHeader>();
+    size.add(p_data.backend);
+    add_array(&size, p_data.solver_parameters);
+    add_array(&size, p_data.matrix.d_row_starts);
+    add_array(&size, p_data.matrix.d_indices);
+    add_array(&size, p_data.matrix.d_values);
+    size.add(p_data.matrix.d_num_cols);
+    add_array(&size, p_data.objective);
+    add_array(&size, p_data.variable_lower);
+    add_array(&size, p_data.variable_upper);
+    add_array(&size, p_data.constraint_lower);
+    add_array(&size, p_data.constraint_upper);
+    add_array(&size, p_data.variable_type);
+    size.add(p_data.objective_sense);
+    add_array(&size, p_data.start_solution);
+
+    size.add(p_data.num_threads)
+        .add(p_data.deterministic)
+        .add(p_data.log_level)
+        .add(p_data.presolve)
+        .add(p_data.max_seconds)
+        .add(p_data.max_nodes)
+        .add(p_data.max_solutions)
+        .add(p_data.max_abs_gap)
+        .add(p_data.max_rel_gap)
+        .add(p_data.cutoff)
+        .add(p_data.interim_policy.min_interval_seconds)
+        .add(p_data.interim_policy.min_relative_improvement)
+        .add(p_data.interim_policy.coalesce);
+
+    const auto buffer_size = result_buffer_size(isize(p_data.objective), p_data.matrix.num_rows());
+    return num_bytes_with_padding(size.required_bytes()) + ResultSlot::required_bytes(buffer_size);
 }
 
 
-static void* serialize_ilp_data(void* p_address, const ILPData& p_data)
+static ResultSlot* serialize_ilp_data(void* p_address, std::size_t p_size, const ILPData& p_data)
 {
-    Serializer serializer(p_address);
-    return serialize_ilp_data(&serializer, p_data, ILPSolutionData(p_data.objective_sense));
+    Serializer serializer(p_address, c_layout);
+    const auto end_address = serialize_ilp_data(&serializer, SerializationHeader::create(p_size), p_data);
+    const auto buffer_size = result_buffer_size(isize(p_data.objective), p_data.matrix.num_rows());
+    return create_result_slot(end_address, buffer_size, ILPSolutionData(p_data.objective_sense));
 }
 
 
 /******************************
  * Communication of the parent *
  ******************************/
-static std::unique_ptr<ip::windows_shared_memory> determine_free_shared_memory_name(size_t p_size, std::string* r_shared_memory_name)
-{
-    for (auto trial = 1; trial <= c_num_shared_memory_name_trials; ++trial)
-    {
-        *r_shared_memory_name = c_shared_memory_base_name + std::to_string(trial);
-        try
-        {
-            return std::make_unique<ip::windows_shared_memory>(ip::create_only, r_shared_memory_name->c_str(),
-                                                               ip::read_write, p_size);
-        }
-        catch (const ip::interprocess_exception& p_e)
-        {
-            if (p_e.get_error_code() != ip::error_code_t::already_exists_error || trial == c_num_shared_memory_name_trials)
-                throw;
-        }
-    }
-    return {};
-}
-
-
 std::string CommunicationParent::create_shared_memory(size_t p_size)
 {
     std::string shared_memory_name;
-    d_shared_memory = determine_free_shared_memory_name(p_size, &shared_memory_name);
+    d_shared_memory = create_shared_memory_segment(p_size, &shared_memory_name);
     d_mapped_region = std::make_unique<ip::mapped_region>(*d_shared_memory, ip::read_write);
     d_address       = d_mapped_region->get_address();
     return shared_memory_name;
@@ -159,15 +407,51 @@ std::string CommunicationParent::write_ilp_data(const ILPData& p_data)
 {
     const auto size               = determine_required_size(p_data);
     const auto shared_memory_name = create_shared_memory(size);
-    d_result_address              = serialize_ilp_data(d_address, p_data);
+    d_result_slot                 = serialize_ilp_data(d_address, size, p_data);
     return shared_memory_name;
 }
 
 
 void CommunicationParent::read_solution_data(ILPSolutionData* r_solution_data)
 {
-    Deserializer deserializer(d_result_address);
-    deserialize_result(&deserializer, r_solution_data);
+    d_num_commits_read = read_result(d_result_slot, r_solution_data);
+}
+
+
+void CommunicationParent::peek_solution_data(ILPSolutionData* r_solution_data) const
+{
+    read_result(d_result_slot, r_solution_data);
+}
+
+
+void CommunicationParent::remove_name_once_read()
+{
+#ifndef _WIN32
+    if (d_result_slot->data_read.load(std::memory_order_acquire))
+        d_shared_memory->remove_name();
+#endif
+}
+
+
+void CommunicationParent::request_stop()
+{
+    d_result_slot->stop_requested.store(true, std::memory_order_relaxed);
+}
+
+
+SolverActivity CommunicationParent::read_activity() const
+{
+    return {d_result_slot->num_heartbeats.load(std::memory_order_relaxed),
+            d_result_slot->num_commits.load(std::memory_order_relaxed),
+            {d_result_slot->num_nodes.load(std::memory_order_relaxed), d_result_slot->best_bound.load(std::memory_order_relaxed)}};
+}
+
+
+bool CommunicationParent::wait_for_solution_data(std::chrono::milliseconds p_max_wait_time)
+{
+    const auto deadline = boost::posix_time::microsec_clock::universal_time()
+                        + boost::posix_time::milliseconds(p_max_wait_time.count());
+    return wait_for_result(d_result_slot, d_num_commits_read, deadline);
 }
 
 
@@ -176,23 +460,49 @@ void CommunicationParent::read_solution_data(ILPSolutionData* r_solution_data)
  *****************************/
 CommunicationChild::CommunicationChild(const std::string& p_shared_memory_name)
     : d_shared_memory(ip::open_only, p_shared_memory_name.c_str(), ip::read_write),
-      d_mapped_region(d_shared_memory, ip::read_write), d_address(d_mapped_region.get_address()), d_result_address(nullptr)
+      d_mapped_region(d_shared_memory, ip::read_write), d_address(d_mapped_region.get_address()), d_result_slot(nullptr)
 {}
 
 
 ILPDataView CommunicationChild::read_ilp_data()
 {
-    Deserializer deserializer(d_address);
+    Deserializer deserializer(d_address, c_layout);
     ILPDataView  data;
-    d_result_address = deserialize_ilp_data(deserializer, data);
+    const auto   end_address = deserialize_ilp_data(&deserializer, &data, d_mapped_region.get_size(), &d_array_regions);
+
+    d_result_slot = result_slot_address(end_address);
+    const auto available_bytes = static_cast<char*>(d_address) + d_mapped_region.get_size() - reinterpret_cast<char*>(d_result_slot);
+    if (available_bytes < static_cast<std::ptrdiff_t>(ResultSlot::header_size())
+        || static_cast<std::size_t>(available_bytes) < ResultSlot::required_bytes(d_result_slot->buffer_size))
+        throw std::runtime_error("Shared memory is smaller than the result slot stored in it.");
+    d_result_slot->data_read.store(true, std::memory_order_release);
     return data;
 }
 
 
 void CommunicationChild::write_solution_data(const ILPSolutionData& p_solution_data)
 {
-    Serializer serializer(d_result_address);
-    serialize_result(&serializer, p_solution_data);
+    write_result(d_result_slot, p_solution_data);
+}
+
+
+void CommunicationChild::write_heartbeat()
+{
+    d_result_slot->num_heartbeats.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+void CommunicationChild::write_progress(const SolverProgress& p_progress)
+{
+    d_result_slot->num_nodes.store(p_progress.num_nodes, std::memory_order_relaxed);
+    d_result_slot->best_bound.store(p_progress.best_bound, std::memory_order_relaxed);
+    write_heartbeat();
+}
+
+
+bool CommunicationChild::stop_requested() const
+{
+    return d_result_slot->stop_requested.load(std::memory_order_relaxed);
 }
 
 } // namespace ilp_solver
@@ -1,30 +1,72 @@
 #pragma once
 
 #include "ilp_data.hpp"
+#include "shared_memory.hpp"
+#include "solver_exit_code.hpp"
 
 #include <boost/interprocess/mapped_region.hpp>
-#include <boost/interprocess/windows_shared_memory.hpp>
+#include <boost/interprocess/sync/interprocess_semaphore.hpp>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 
 namespace ilp_solver
 {
 
+// Double-buffered area behind the ILP data, to which the child writes solutions.
+struct ResultSlot;
+
+// What the child has reported so far. The parent compares these over time to see whether the child is alive and progressing.
+struct SolverActivity
+{
+    std::uint64_t  num_heartbeats{0};   // Increases whenever the solver checks the stop condition or reports progress.
+    std::uint64_t  num_solutions{0};    // Solutions written by the child.
+    SolverProgress progress;
+
+    bool operator==(const SolverActivity&) const = default;
+};
+
 class CommunicationParent
 {
 public:
     // Returns the name of the shared memory segment the data has been written to
     std::string write_ilp_data(const ILPData& p_data);
+
+    // Reads the last solution the child has written completely, even if it has been killed while writing another one.
+    // May be called while the child is running.
     void        read_solution_data(ILPSolutionData* r_solution_data);
 
+    // Like read_solution_data, but the solution does not count as read for wait_for_solution_data.
+    // Thus, another thread may peek while one waits for and reads the solutions.
+    void        peek_solution_data(ILPSolutionData* r_solution_data) const;
+
+    // Waits at most p_max_wait_time for the child to write a solution after the one read last.
+    // Returns whether it has written one, which can be read by read_solution_data.
+    bool        wait_for_solution_data(std::chrono::milliseconds p_max_wait_time);
+
+    // Asks the child to stop solving as soon as possible and to write its best solution (see CommunicationChild).
+    void        request_stop();
+
+    // On POSIX, removes the name of the shared memory once the child has read the data,
+    // such that the memory is freed even if this process crashes (see SharedMemory).
+    // On Windows, the memory is freed with its last handle anyway. May be called while the child is running.
+    void        remove_name_once_read();
+
+    // Returns what the child has reported so far. May be called while the child is running.
+    SolverActivity read_activity() const;
+
 private:
-    std::unique_ptr<boost::interprocess::windows_shared_memory> d_shared_memory{};
-    std::unique_ptr<boost::interprocess::mapped_region>         d_mapped_region{};
+    std::unique_ptr<SharedMemory>                       d_shared_memory{};
+    std::unique_ptr<boost::interprocess::mapped_region> d_mapped_region{};
 
-    // non-owned pointer; do not delete
-    void* d_address{};
-    void* d_result_address{};
+    // non-owned pointers; do not delete
+    void*       d_address{};
+    ResultSlot* d_result_slot{};
+
+    std::uint64_t d_num_commits_read{0};   // Number of solutions the child had written up to the one read last.
 
     std::string create_shared_memory(size_t p_size);
 };
@@ -40,13 +82,42 @@ public:
     ILPDataView read_ilp_data();
     void        write_solution_data(const ILPSolutionData& p_solution_data);
 
+    // Whether the parent has called request_stop. Thread-safe, such that the solver may poll it.
+    bool        stop_requested() const;
+
+    // Tell the parent that the solver is alive, and how far it has got. Thread-safe like stop_requested.
+    void        write_heartbeat();
+    void        write_progress(const SolverProgress& p_progress);
+
 private:
-    const boost::interprocess::windows_shared_memory d_shared_memory;
-    const boost::interprocess::mapped_region         d_mapped_region;
+    const SharedMemory                       d_shared_memory;
+    const boost::interprocess::mapped_region d_mapped_region;
 
-    // non-owned pointer; do not delete
+    // Regions of arrays that the parent has allocated in shared memory segments of their own (see SharedMemoryArena).
+    std::vector<std::unique_ptr<boost::interprocess::mapped_region>> d_array_regions;
+
+    // non-owned pointers; do not delete
     void* const d_address;
-    void*       d_result_address;
+    ResultSlot* d_result_slot;
+};
+
+
+// Job slot of a worker process of WorkerPool, placed at the start of a shared memory segment of its own.
+// The parent writes the name of the shared memory of a job (see CommunicationParent) and posts job_posted.
+// The worker solves the job, writes its exit code and posts job_done.
+// If shutdown is set when job_posted is posted, the worker ends.
+// An idle worker also ends if the process with parent_process_id has ended, e.g. by a crash.
+struct WorkerSlot
+{
+    static constexpr int c_max_name_size = 64;
+
+    boost::interprocess::interprocess_semaphore job_posted{0};
+    boost::interprocess::interprocess_semaphore job_done{0};
+
+    char           shared_memory_name[c_max_name_size]{};
+    SolverExitCode exit_code{SolverExitCode::ok};
+    bool           shutdown{false};
+    std::uint64_t  parent_process_id{0};
 };
 
 } // namespace ilp_solver
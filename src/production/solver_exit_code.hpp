@@ -1,5 +1,9 @@
 #pragma once
 
+#ifndef _WIN32
+#include <csignal>
+#endif
+
 enum class SolverExitCode
 {
     ok = 0,
@@ -43,7 +47,8 @@ enum class SolverExitCode
     solver_error,
     forced_termination,
     invalid_start_solution,
-    stub_tester_failed
+    stub_tester_failed,
+    backend_error
 };
 
 static_assert (static_cast<int>(SolverExitCode::uncaught_exception_1) == 0x00000003);
@@ -52,3 +57,42 @@ static_assert (static_cast<int>(SolverExitCode::uncaught_exception_3) == 0xC0000
 static_assert (static_cast<int>(SolverExitCode::uncaught_exception_4) == 0xC0000374);
 static_assert (static_cast<int>(SolverExitCode::uncaught_exception_5) == 0xC0000005);
 static_assert (static_cast<int>(SolverExitCode::missing_dll)          == 0xC0000135);
+
+
+// On POSIX systems, the exit status of a process has only 8 bits, and crashes are reported as signals
+// (boost::process::child::exit_code() returns the signal number then).
+// So ScaiIlpExe exits with c_posix_exit_code_offset + (code - out_of_memory) for our own exit codes,
+// and the stub maps them and the signals back. On Windows, both functions are the identity.
+constexpr int c_posix_exit_code_offset = 64;
+
+inline int to_process_exit_code(SolverExitCode p_exit_code)
+{
+#ifdef _WIN32
+    return static_cast<int>(p_exit_code);
+#else
+    if (p_exit_code >= SolverExitCode::out_of_memory)
+        return c_posix_exit_code_offset + static_cast<int>(p_exit_code) - static_cast<int>(SolverExitCode::out_of_memory);
+    return static_cast<int>(p_exit_code);
+#endif
+}
+
+inline SolverExitCode from_process_exit_code(int p_exit_code)
+{
+#ifdef _WIN32
+    return SolverExitCode(p_exit_code);
+#else
+    constexpr auto num_own_exit_codes = static_cast<int>(SolverExitCode::backend_error)
+                                      - static_cast<int>(SolverExitCode::out_of_memory) + 1;
+    if (p_exit_code >= c_posix_exit_code_offset && p_exit_code < c_posix_exit_code_offset + num_own_exit_codes)
+        return SolverExitCode(static_cast<int>(SolverExitCode::out_of_memory) + p_exit_code - c_posix_exit_code_offset);
+
+    switch (p_exit_code)
+    {
+    case SIGKILL: return SolverExitCode::killed_via_task_manager;
+    case SIGABRT: return SolverExitCode::uncaught_exception_2; // std::terminate, e.g., for an uncaught exception
+    case SIGSEGV:
+    case SIGBUS:  return SolverExitCode::uncaught_exception_5; // access violation
+    default:      return SolverExitCode(p_exit_code);
+    }
+#endif
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "ilp_solver_interface.hpp"
+#include "watchdog_policy.hpp"
+
+namespace ilp_solver
+{
+    struct PortfolioRacer;
+
+    // How create_solver_stub creates an ILPSolverStub (see its constructor for the meaning of each option).
+    // The options combine freely, e.g. a prelaunched stub of another backend or a portfolio with its own WatchdogPolicy.
+    // Passed to the DLL by pointer like WatchdogPolicy, so it only holds values and pointers owned by the caller.
+    struct StubOptions
+    {
+        const char*           executable_basename{"ScaiIlpExe.exe"};
+        bool                  throw_on_all_crashes{false};
+        int                   num_workers{0};                      // 0 for a new process per ILP.
+        bool                  prelaunch{false};
+        SolverBackend         backend{SolverBackend::DEFAULT};
+        WatchdogPolicy        watchdog_policy{};
+        const PortfolioRacer* racers{nullptr};                     // num_racers of them race on each ILP; copied by the stub.
+        int                   num_racers{0};
+    };
+}
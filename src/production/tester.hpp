@@ -1,5 +1,6 @@
 #pragma once
 
+#include "platform.hpp"
 #include "solver_exit_code.hpp"
 
 #include <string>
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cassert>
+#include <chrono>
 #include <limits>
 #include <utility>
 #include <vector> // for std::size
@@ -12,3 +13,13 @@ constexpr int isize(const Container& p_container)
     assert(std::cmp_less(size, std::numeric_limits<int>::max()));
     return static_cast<int>(size);
 }
+
+
+// p_seconds after p_start. Clamped, such that the default time limit (the maximal double) does not overflow.
+inline std::chrono::steady_clock::time_point time_after(std::chrono::steady_clock::time_point p_start, double p_seconds)
+{
+    const auto max_seconds = std::chrono::duration<double>(std::chrono::steady_clock::duration::max() / 2).count();
+    if (p_seconds >= max_seconds)
+        return p_start + std::chrono::steady_clock::duration::max() / 2;
+    return p_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(p_seconds));
+}
@@ -0,0 +1,97 @@
+#ifdef WITH_STUB
+
+#include "watchdog.hpp"
+
+#include "utility.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <format>
+#include <utility>
+
+namespace ilp_solver
+{
+Watchdog::Watchdog(const WatchdogPolicy& p_policy, double p_max_seconds, CommunicationParent* v_communicator,
+                   std::function<bool(const SolverProgress*)> p_check_stop)
+    : d_policy(p_policy), d_max_seconds(p_max_seconds), d_communicator(v_communicator), d_check_stop(std::move(p_check_stop))
+{
+    assert(p_policy.gap_factor >= 0. && p_policy.relative_overtime >= 0.);
+    start();
+}
+
+
+void Watchdog::start()
+{
+    const auto start_time = Clock::now();
+    d_stop_time      = time_after(start_time, d_max_seconds + d_policy.stop_request_seconds);
+    d_kill_time      = time_after(start_time, (1. + d_policy.relative_overtime)*d_max_seconds + d_policy.absolute_overtime_seconds);
+    d_last_heartbeat = start_time;
+    d_last_progress  = start_time;
+    if (d_stop_requested)
+        d_stop_time = start_time;
+}
+
+
+bool Watchdog::stop_requested_before_start()
+{
+    if (!d_stop_requested && d_check_stop && d_check_stop(nullptr))
+        request_stop();
+    return d_stop_requested;
+}
+
+
+bool Watchdog::check()
+{
+    const auto now      = Clock::now();
+    const auto activity = d_communicator->read_activity();
+    d_communicator->remove_name_once_read();
+
+    // Progress is also a sign of life.
+    if (activity.num_solutions != d_activity.num_solutions || activity.progress != d_activity.progress)
+    {
+        d_longest_progress_gap = std::max(d_longest_progress_gap, Seconds(now - d_last_progress));
+        d_last_progress        = now;
+    }
+    if (activity.num_heartbeats != d_activity.num_heartbeats || d_last_progress == now)
+    {
+        d_longest_heartbeat_gap = std::max(d_longest_heartbeat_gap, Seconds(now - d_last_heartbeat));
+        d_last_heartbeat        = now;
+    }
+    d_activity = activity;
+
+    if (d_check_stop && d_check_stop(&activity.progress))
+        request_stop();
+    if (now < d_stop_time)
+        return false;
+    request_stop();
+
+    // After the stop request, the process gets at least the timeouts to end.
+    const auto idle_time     = Seconds(now - std::max(d_last_heartbeat, d_stop_time));
+    const auto stall_time    = Seconds(now - std::max(d_last_progress, d_stop_time));
+    const auto idle_timeout  = std::max(Seconds(d_policy.idle_timeout_seconds), d_policy.gap_factor*d_longest_heartbeat_gap);
+    const auto stall_timeout = std::max(Seconds(d_policy.stall_timeout_seconds), d_policy.gap_factor*d_longest_progress_gap);
+
+    if (now >= d_kill_time)
+        d_kill_reason = "maximal overtime exceeded";
+    else if (idle_time >= idle_timeout)
+        d_kill_reason = std::format("no heartbeat for {:.1f}s", idle_time.count());
+    else if (stall_time >= stall_timeout)
+        d_kill_reason = std::format("no progress for {:.1f}s", stall_time.count());
+    else
+        return false;
+    return true;
+}
+
+
+void Watchdog::request_stop()
+{
+    if (d_stop_requested)
+        return;
+    d_communicator->request_stop();
+    d_stop_requested = true;
+    d_stop_time      = std::min(d_stop_time, Clock::now());
+}
+
+} // namespace ilp_solver
+
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "shared_memory_communication.hpp"
+#include "watchdog_policy.hpp"
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+namespace ilp_solver
+{
+    // How often a running process should be checked by Watchdog::check.
+    constexpr auto c_watchdog_check_interval = std::chrono::milliseconds(50);
+
+
+    // Applies a WatchdogPolicy to one solve, which the child of v_communicator is running.
+    // The time starts with the construction and again with start.
+    // At each check, p_check_stop (if given) gets the progress of the process and returns whether to ask it to stop now,
+    // such that the stop condition and the progress handler of the stub apply to the process.
+    // Before the process has started to solve, p_check_stop gets nullptr.
+    class Watchdog
+    {
+        public:
+            Watchdog(const WatchdogPolicy& p_policy, double p_max_seconds, CommunicationParent* v_communicator,
+                     std::function<bool(const SolverProgress*)> p_check_stop = {});
+
+            // Starts the time anew. Call when the process starts to solve, such that the time
+            // the job has waited before, e.g. for a worker of a pool, does not count against the time limit.
+            void start();
+
+            // Whether the stop condition already holds before the process has started to solve.
+            // Call regularly while the job waits. If true, the job need not be solved at all.
+            bool stop_requested_before_start();
+
+            // Observes the process, asks it to stop when due and returns whether it should be killed now.
+            // Once the process has read the ILP, this also removes the name of its shared memory (see CommunicationParent).
+            // Call regularly while the process is running.
+            bool check();
+
+            // Why check has returned true.
+            const std::string& kill_reason() const { return d_kill_reason; }
+
+        private:
+            using Clock   = std::chrono::steady_clock;
+            using Seconds = std::chrono::duration<double>;
+
+            const WatchdogPolicy                       d_policy;
+            const double                               d_max_seconds;
+            CommunicationParent*                       d_communicator;
+            std::function<bool(const SolverProgress*)> d_check_stop;
+
+            Clock::time_point                          d_stop_time;
+            Clock::time_point                          d_kill_time;
+            bool                                       d_stop_requested{false};
+
+            SolverActivity                             d_activity;
+            Clock::time_point                          d_last_heartbeat;
+            Clock::time_point                          d_last_progress;
+            Seconds                                    d_longest_heartbeat_gap{0.};
+            Seconds                                    d_longest_progress_gap{0.};
+
+            std::string                                d_kill_reason;
+
+            void request_stop();
+    };
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+namespace ilp_solver
+{
+    // Decides how long ILPSolverStub waits for a solver process that exceeds its time limit (max_seconds).
+    //
+    // Shortly after the time limit, the process is asked to stop, which solvers do at their next check.
+    // If it does not end, it is killed as soon as it seems stuck, judged by what it reports (see SolverActivity):
+    // - Liveness: The solver checks the stop condition or reports progress (heartbeat).
+    //   A solver in a phase without such checks, e.g. a long LP solve, or a hanging solver does not beat.
+    // - Progress: The solver processes nodes, improves its bound or finds solutions.
+    //   A solver that beats but ignores the stop request makes no progress in the long run.
+    // The timeouts adapt to the process: They are at least gap_factor times the longest gap observed so far,
+    // such that a solver whose LPs took minutes before the time limit is not killed during its next one after seconds.
+    //
+    // Regardless, the process is killed relative_overtime*max_seconds + absolute_overtime_seconds after the time limit.
+    // This is only a safety net; before the watchdog, fixed values of this kind were the only limit (see AXS-1452, AXS-2636).
+    struct WatchdogPolicy
+    {
+        double stop_request_seconds{1.};        // After max_seconds.
+        double idle_timeout_seconds{10.};       // Minimum time without heartbeat before the kill.
+        double stall_timeout_seconds{30.};      // Minimum time without progress before the kill.
+        double gap_factor{2.};
+        double relative_overtime{1.};
+        double absolute_overtime_seconds{60.};
+    };
+}
@@ -0,0 +1,232 @@
+#ifdef WITH_STUB
+
+#include "worker_pool.hpp"
+
+#include "shared_memory_arena.hpp"
+#include "shared_memory_communication.hpp"
+#include "watchdog.hpp"
+
+#include <algorithm>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/process.hpp>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <new>
+#include <system_error>
+#include <thread>
+
+namespace ip = boost::interprocess;
+
+// How long idle workers get to end when the pool is destroyed.
+constexpr auto c_shutdown_timeout = std::chrono::seconds(2);
+
+namespace ilp_solver
+{
+
+struct WorkerPool::Worker
+{
+    std::string                        slot_name;
+    std::unique_ptr<SharedMemory>      shared_memory;
+    std::unique_ptr<ip::mapped_region> mapped_region;
+    WorkerSlot*                        slot{nullptr};
+    boost::process::child              process;
+
+    bool is_running()
+    {
+        std::error_code error;
+        return process.valid() && process.running(error);
+    }
+
+    ~Worker()
+    {
+        std::error_code error;
+        if (is_running())
+            process.terminate(error);
+        if (slot != nullptr)
+            slot->~WorkerSlot();
+    }
+};
+
+
+WorkerPool& WorkerPool::instance(const boost::filesystem::path& p_executable_path, int p_max_workers)
+{
+    static std::mutex                                                     s_mutex;
+    static std::map<boost::filesystem::path, std::unique_ptr<WorkerPool>> s_pools;
+
+    std::lock_guard lock(s_mutex);
+    auto&           pool = s_pools[p_executable_path];
+    if (!pool)
+        pool.reset(new WorkerPool(p_executable_path, p_max_workers));
+    else
+    {
+        std::lock_guard pool_lock(pool->d_mutex);
+        pool->d_max_workers = std::max(pool->d_max_workers, p_max_workers);
+    }
+    return *pool;
+}
+
+
+WorkerPool::WorkerPool(const boost::filesystem::path& p_executable_path, int p_max_workers)
+    : d_executable_path(p_executable_path), d_max_workers(p_max_workers)
+{
+    assert(p_max_workers > 0);
+}
+
+
+// Asks idle workers to end. Busy workers and idle ones that do not end in time are killed by ~Worker,
+// such that a hung worker does not block the destruction of the pool, e.g. of instance at exit.
+WorkerPool::~WorkerPool()
+{
+    for (auto& worker : d_idle_workers)
+    {
+        worker->slot->shutdown = true;
+        worker->slot->job_posted.post();
+    }
+    // Poll instead of waiting without a limit (see also ILPSolverStub::run_process).
+    const auto deadline = std::chrono::steady_clock::now() + c_shutdown_timeout;
+    while (std::ranges::any_of(d_idle_workers, [](const auto& p_worker) { return p_worker->is_running(); })
+           && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(c_watchdog_check_interval);
+}
+
+
+SolverExitCode WorkerPool::solve(const std::string& p_shared_memory_name, Watchdog* v_watchdog)
+{
+    assert(static_cast<int>(p_shared_memory_name.size()) < WorkerSlot::c_max_name_size);
+
+    auto worker = acquire_worker(v_watchdog);
+    if (!worker)
+        return SolverExitCode::ok; // Stopped while waiting for a worker. The job has no solution.
+    auto& slot = *worker->slot;
+
+    std::fill(std::begin(slot.shared_memory_name), std::end(slot.shared_memory_name), '\0');
+    p_shared_memory_name.copy(slot.shared_memory_name, p_shared_memory_name.size());
+    slot.exit_code = SolverExitCode::ok;
+    slot.job_posted.post();
+    v_watchdog->start();
+
+    // A busy worker is checked for having crashed in the same interval as by the watchdog.
+    while (true)
+    {
+        const auto poll_time = boost::posix_time::microsec_clock::universal_time()
+                             + boost::posix_time::milliseconds(c_watchdog_check_interval.count());
+        if (slot.job_done.timed_wait(poll_time))
+        {
+            const auto exit_code = slot.exit_code;
+            release_worker(std::move(worker));
+            return exit_code;
+        }
+
+        SolverExitCode exit_code;
+        if (!worker->is_running())
+            exit_code = from_process_exit_code(worker->process.exit_code());
+        else if (v_watchdog->check())
+            exit_code = SolverExitCode::forced_termination; // ~Worker kills the process.
+        else
+            continue;
+
+        // The worker is replaced when the next job needs one.
+        worker.reset();
+        {
+            std::lock_guard lock(d_mutex);
+            --d_num_workers;
+        }
+        d_worker_released.notify_one();
+        return exit_code;
+    }
+}
+
+
+void WorkerPool::prelaunch()
+{
+    {
+        std::lock_guard lock(d_mutex);
+        if (!d_idle_workers.empty() || d_num_workers >= d_max_workers)
+            return;
+        ++d_num_workers;
+    }
+
+    try
+    {
+        release_worker(start_worker());
+    }
+    catch (...)
+    {
+        std::lock_guard lock(d_mutex);
+        --d_num_workers;
+    }
+}
+
+
+std::unique_ptr<WorkerPool::Worker> WorkerPool::acquire_worker(Watchdog* v_watchdog)
+{
+    std::unique_lock lock(d_mutex);
+    while (true)
+    {
+        while (!d_idle_workers.empty())
+        {
+            auto worker = std::move(d_idle_workers.back());
+            d_idle_workers.pop_back();
+            if (worker->is_running())
+                return worker;
+            --d_num_workers; // Ended while idle, e.g., killed from outside.
+        }
+
+        if (d_num_workers < d_max_workers)
+        {
+            ++d_num_workers;
+            lock.unlock();
+            try
+            {
+                return start_worker();
+            }
+            catch (...)
+            {
+                lock.lock();
+                --d_num_workers;
+                throw;
+            }
+        }
+
+        // While all workers are busy, the job may be stopped, e.g. because another racer of a portfolio has won.
+        d_worker_released.wait_for(lock, c_watchdog_check_interval);
+        lock.unlock();
+        const auto stop = v_watchdog->stop_requested_before_start();
+        lock.lock();
+        if (stop)
+            return nullptr;
+    }
+}
+
+
+void WorkerPool::release_worker(std::unique_ptr<Worker> p_worker)
+{
+    {
+        std::lock_guard lock(d_mutex);
+        d_idle_workers.push_back(std::move(p_worker));
+    }
+    d_worker_released.notify_one();
+}
+
+
+// The output of workers is always suppressed, because the log level may differ from job to job.
+// See ILPSolverStub::solve_impl why suppressing is necessary at log level zero.
+std::unique_ptr<WorkerPool::Worker> WorkerPool::start_worker() const
+{
+    auto worker           = std::make_unique<Worker>();
+    worker->shared_memory = create_shared_memory_segment(sizeof(WorkerSlot), &worker->slot_name);
+    worker->mapped_region = std::make_unique<ip::mapped_region>(*worker->shared_memory, ip::read_write);
+    worker->slot          = new (worker->mapped_region->get_address()) WorkerSlot();
+    worker->slot->parent_process_id = static_cast<std::uint64_t>(boost::this_process::get_id());
+    worker->process       = boost::process::child(d_executable_path, "--worker", worker->slot_name,
+                                                  boost::process::std_out > boost::process::null,
+                                                  boost::process::std_err > boost::process::null);
+    return worker;
+}
+
+} // namespace ilp_solver
+
+#endif
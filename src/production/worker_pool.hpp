@@ -0,0 +1,68 @@
+#pragma once
+
+#ifdef WITH_STUB
+
+#include "shared_memory.hpp"
+#include "solver_exit_code.hpp"
+
+#include <boost/filesystem/path.hpp>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ilp_solver
+{
+    class  Watchdog;
+    struct WorkerSlot;
+
+    // Long-lived ScaiIlpExe processes ("ScaiIlpExe --worker <slot>") that solve one job after the other.
+    // This saves starting a process and loading the solver libraries for each ILP.
+    // Each worker waits on its WorkerSlot in shared memory for the name of the next job's shared memory.
+    // A worker that crashes or exceeds the time limit is replaced by a new one for the next job.
+    // Thread-safe: Up to the maximum number of workers, jobs are solved in parallel.
+    class WorkerPool
+    {
+        public:
+            // Returns the pool of p_executable_path. The pool starts workers as needed,
+            // up to the largest p_max_workers any caller has requested.
+            static WorkerPool& instance(const boost::filesystem::path& p_executable_path, int p_max_workers);
+
+            // A pool of its own, e.g. to keep a prelaunched worker for one ILPSolverStub.
+            WorkerPool(const boost::filesystem::path& p_executable_path, int p_max_workers);
+
+            // Solves the ILP that has been written to p_shared_memory_name, watched by v_watchdog.
+            // The time of v_watchdog starts when a worker takes the job.
+            // Returns SolverExitCode::ok without solving if v_watchdog says to stop while the job waits for a worker,
+            // the exit code the worker has reported,
+            // the exit code of the worker process if it has crashed,
+            // or SolverExitCode::forced_termination if it has been killed because v_watchdog said so.
+            SolverExitCode solve(const std::string& p_shared_memory_name, Watchdog* v_watchdog);
+
+            // Starts a worker unless one is idle or the maximum number is running,
+            // such that the next job need not wait for the worker to start and to create its solver.
+            // Errors are ignored; the next job tries to start a worker again and reports them.
+            void prelaunch();
+
+            WorkerPool(const WorkerPool&)            = delete;
+            WorkerPool& operator=(const WorkerPool&) = delete;
+            ~WorkerPool();
+
+        private:
+            struct Worker;
+
+            const boost::filesystem::path        d_executable_path;
+            int                                  d_max_workers;
+            int                                  d_num_workers{0};   // Idle and busy ones.
+            std::vector<std::unique_ptr<Worker>> d_idle_workers;
+            std::mutex                           d_mutex;
+            std::condition_variable              d_worker_released;
+
+            std::unique_ptr<Worker> acquire_worker(Watchdog* v_watchdog); // nullptr if stopped while waiting.
+            void                    release_worker(std::unique_ptr<Worker> p_worker);
+            std::unique_ptr<Worker> start_worker() const;
+    };
+}
+
+#endif
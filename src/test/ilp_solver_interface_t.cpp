@@ -1,5 +1,7 @@
+#include "ilp_data.hpp"
 #include "ilp_solver_factory.hpp"
 #include "ilp_solver_interface.hpp"
+#include "mps_reader.hpp"
 
 #include "utility.hpp"
 
@@ -8,9 +10,13 @@
 #include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 #include <chrono>
+#include <cmath>
+#include <functional>
 #include <iostream>
+#include <numeric>
 #include <string>
 #include <string_view>
+#include <thread>
 
 
 const auto c_eps = 0.0001;
@@ -300,7 +306,7 @@ namespace ilp_solver
 
 
     // Tests only for file creation and non-null-size.
-    // Correctness of file can only be tested if we implement reading from mps, too.
+    // The content of the file written by ILPSolverCollect is checked by test_mps_round_trip.
     void test_mps_output(ILPSolverInterface* p_solver, const std::string& p_path)
     {
         // Disable output for problem construction and solve.
@@ -321,6 +327,44 @@ namespace ilp_solver
     }
 
 
+    // Writes a model with all kinds of variables and rows and reads it back.
+    // The free row and the zero coefficient are not part of the model.
+    void test_mps_round_trip(ILPSolverInterface* p_solver, const std::string& p_path)
+    {
+        p_solver->add_variable_continuous(1., -1.5, 2.25);
+        p_solver->add_variable_integer(-2., 0., 7.);
+        p_solver->add_variable_boolean(0.5);
+        p_solver->add_variable_continuous(0., c_neg_inf, c_pos_inf);
+
+        p_solver->add_constraint_upper(std::vector{0, 1, 2}, std::vector{1., 2., 0.}, 4.);
+        p_solver->add_constraint_lower(std::vector{1, 2}, std::vector{3., -1.}, -1.);
+        p_solver->add_constraint_equality(std::vector{0, 3}, std::vector{1., 1.}, 2.);
+        p_solver->add_constraint(std::vector{1., 1., 1., 1.}, c_neg_inf, c_pos_inf);
+        p_solver->add_constraint(std::vector{2, 3}, std::vector{1., 0.5}, 1., 3.);
+
+        // Appended as a column, after the rows.
+        p_solver->add_variable_integer(std::vector{0, 3}, std::vector{-1., 0.25}, 3., -4., 4.);
+
+        boost::filesystem::remove(p_path);
+        p_solver->print_mps_file(p_path);
+        const auto data = read_mps_file(p_path);
+
+        BOOST_REQUIRE(data.objective      == (std::pmr::vector<double>{1., -2., 0.5, 0., 3.}));
+        BOOST_REQUIRE(data.variable_lower == (std::pmr::vector<double>{-1.5, 0., 0., c_neg_inf, -4.}));
+        BOOST_REQUIRE(data.variable_upper == (std::pmr::vector<double>{2.25, 7., 1., c_pos_inf, 4.}));
+        BOOST_REQUIRE(data.variable_type  == (std::pmr::vector<VariableType>{VariableType::CONTINUOUS, VariableType::INTEGER,
+                                                                            VariableType::BINARY, VariableType::CONTINUOUS,
+                                                                            VariableType::INTEGER}));
+
+        BOOST_REQUIRE(data.constraint_lower == (std::pmr::vector<double>{c_neg_inf, -1., 2., 1.}));
+        BOOST_REQUIRE(data.constraint_upper == (std::pmr::vector<double>{4., c_pos_inf, 2., 3.}));
+
+        BOOST_REQUIRE(data.matrix.d_row_starts == (std::pmr::vector<int>{0, 3, 5, 7, 10}));
+        BOOST_REQUIRE(data.matrix.d_indices    == (std::pmr::vector<int>{0, 1, 4, 1, 2, 0, 3, 2, 3, 4}));
+        BOOST_REQUIRE(data.matrix.d_values     == (std::pmr::vector<double>{1., 2., -1., 3., -1., 1., 1., 1., 0.5, 0.25}));
+    }
+
+
     void test_performance(ILPSolverInterface* p_solver)
     {
         // max x+y, -1 <= x, y <= 1
@@ -424,6 +468,141 @@ namespace ilp_solver
     }
 
 
+    void test_bulk_loading(ILPSolverInterface* p_solver)
+    {
+        // max 5*x0 + 4*x1 + 3*x2 + y + z, x0, x1, x2 binary, 0 <= y <= 2.5 continuous, 0 <= z <= 3 integral
+        // s.t. 2*x0 + 3*x1 + x2 + y <= 5
+        //      x0 + x1                 (free, thus skipped)
+        //      y + z <= 3.5
+        // The optimum 12 is attained at (1, 1, 0, 0, 3).
+        const std::vector<double>       objectives_x{5., 4., 3.};
+        const std::vector<double>       lower_x(3, 0.);
+        const std::vector<double>       upper_x(3, 1.);
+        const std::vector<VariableType> types_x(3, VariableType::BINARY);
+        p_solver->add_variables(objectives_x, lower_x, upper_x, types_x);
+
+        const std::vector<double> row_lower{c_neg_inf, c_neg_inf, c_neg_inf};
+        const std::vector<double> row_upper{5., c_pos_inf, 3.5};
+        const std::vector<int>    row_starts{0, 3, 5, 5};
+        const std::vector<int>    col_indices{0, 1, 2, 0, 1};
+        const std::vector<double> row_values{2., 3., 1., 1., 1.};
+        p_solver->add_constraints(row_lower, row_upper, row_starts, col_indices, row_values);
+        BOOST_REQUIRE_EQUAL(p_solver->get_num_constraints(), 2);
+
+        // y and z, their factors refer to the two remaining constraints.
+        const std::vector<double>       objectives_yz{1., 1.};
+        const std::vector<double>       lower_yz{0., 0.};
+        const std::vector<double>       upper_yz{2.5, 3.};
+        const std::vector<VariableType> types_yz{VariableType::CONTINUOUS, VariableType::INTEGER};
+        const std::vector<int>          col_starts{0, 2, 3};
+        const std::vector<int>          row_indices{0, 1, 1};
+        const std::vector<double>       col_values{1., 1., 1.};
+        p_solver->add_variables(objectives_yz, lower_yz, upper_yz, types_yz, col_starts, row_indices, col_values);
+        BOOST_REQUIRE_EQUAL(p_solver->get_num_variables(), 5);
+
+        p_solver->maximize();
+        BOOST_REQUIRE(p_solver->get_status() == SolutionStatus::PROVEN_OPTIMAL);
+        BOOST_REQUIRE_CLOSE(p_solver->get_objective(), 12., c_eps);
+
+        const std::vector<double> expected_solution{1., 1., 0., 0., 3.};
+        const auto                solution = p_solver->get_solution();
+        BOOST_REQUIRE_EQUAL(solution.size(), expected_solution.size());
+        for (auto i = 0; i < isize(solution); ++i)
+            BOOST_REQUIRE_SMALL(solution[i] - expected_solution[i], c_eps);
+    }
+
+
+    // Same ILP as in test_bulk_loading, but loaded at once.
+    void test_model_loading(ILPSolverInterface* p_solver)
+    {
+        std::vector<double>       objective{5., 4., 3., 1., 1.};
+        std::vector<double>       variable_lower(5, 0.);
+        std::vector<double>       variable_upper{1., 1., 1., 2.5, 3.};
+        std::vector<VariableType> variable_type{VariableType::BINARY, VariableType::BINARY, VariableType::BINARY,
+                                                VariableType::CONTINUOUS, VariableType::INTEGER};
+        std::vector<double>       constraint_lower(2, c_neg_inf);
+        std::vector<double>       constraint_upper{5., 3.5};
+        std::vector<int>          row_starts{0, 4, 6};
+        std::vector<int>          col_indices{0, 1, 2, 3, 3, 4};
+        std::vector<double>       row_values{2., 3., 1., 1., 1., 1.};
+
+        ILPDataView model;
+        model.objective             = objective;
+        model.variable_lower        = variable_lower;
+        model.variable_upper        = variable_upper;
+        model.variable_type         = variable_type;
+        model.constraint_lower      = constraint_lower;
+        model.constraint_upper      = constraint_upper;
+        model.matrix.d_row_starts   = row_starts;
+        model.matrix.d_indices      = col_indices;
+        model.matrix.d_values       = row_values;
+        model.matrix.d_num_cols     = 5;
+        p_solver->load_model(model);
+        BOOST_REQUIRE_EQUAL(p_solver->get_num_variables(), 5);
+        BOOST_REQUIRE_EQUAL(p_solver->get_num_constraints(), 2);
+
+        p_solver->maximize();
+        BOOST_REQUIRE(p_solver->get_status() == SolutionStatus::PROVEN_OPTIMAL);
+        BOOST_REQUIRE_CLOSE(p_solver->get_objective(), 12., c_eps);
+
+        const std::vector<double> expected_solution{1., 1., 0., 0., 3.};
+        const auto                solution = p_solver->get_solution();
+        BOOST_REQUIRE_EQUAL(solution.size(), expected_solution.size());
+        for (auto i = 0; i < isize(solution); ++i)
+            BOOST_REQUIRE_SMALL(solution[i] - expected_solution[i], c_eps);
+    }
+
+
+    // Loads a model into a solver which already has variables and constraints.
+    void test_model_loading_extend(ILPSolverInterface* p_solver)
+    {
+        // max 5*x0 + 4*x1 + 3*x2 + 0.5*y + z
+        // s.t. 2*x0 + 3*x1 + x2 <= 5   (added before)
+        //      y + z <= 3.5            (loaded, y and z are the model's columns 0 and 1)
+        // The optimum 12.25 is attained at (1, 1, 0, 0.5, 3).
+        p_solver->add_variable_boolean(5.);
+        p_solver->add_variable_boolean(4.);
+        p_solver->add_variable_boolean(3.);
+        const std::vector<double> values_x{2., 3., 1.};
+        p_solver->add_constraint_upper(values_x, 5.);
+
+        std::vector<double>       objective{0.5, 1.};
+        std::vector<double>       variable_lower(2, 0.);
+        std::vector<double>       variable_upper{2.5, 3.};
+        std::vector<VariableType> variable_type{VariableType::CONTINUOUS, VariableType::INTEGER};
+        std::vector<double>       constraint_lower{c_neg_inf};
+        std::vector<double>       constraint_upper{3.5};
+        std::vector<int>          row_starts{0, 2};
+        std::vector<int>          col_indices{0, 1};
+        std::vector<double>       row_values{1., 1.};
+
+        ILPDataView model;
+        model.objective             = objective;
+        model.variable_lower        = variable_lower;
+        model.variable_upper        = variable_upper;
+        model.variable_type         = variable_type;
+        model.constraint_lower      = constraint_lower;
+        model.constraint_upper      = constraint_upper;
+        model.matrix.d_row_starts   = row_starts;
+        model.matrix.d_indices      = col_indices;
+        model.matrix.d_values       = row_values;
+        model.matrix.d_num_cols     = 2;
+        p_solver->load_model(model);
+        BOOST_REQUIRE_EQUAL(p_solver->get_num_variables(), 5);
+        BOOST_REQUIRE_EQUAL(p_solver->get_num_constraints(), 2);
+
+        p_solver->maximize();
+        BOOST_REQUIRE(p_solver->get_status() == SolutionStatus::PROVEN_OPTIMAL);
+        BOOST_REQUIRE_CLOSE(p_solver->get_objective(), 12.25, c_eps);
+
+        const std::vector<double> expected_solution{1., 1., 0., 0.5, 3.};
+        const auto                solution = p_solver->get_solution();
+        BOOST_REQUIRE_EQUAL(solution.size(), expected_solution.size());
+        for (auto i = 0; i < isize(solution); ++i)
+            BOOST_REQUIRE_SMALL(solution[i] - expected_solution[i], c_eps);
+    }
+
+
     void test_start_solution(ILPSolverInterface* p_solver, double p_sense)
     {
         // max x+y+2z (<=> min -(x+y+2z)), 0 <= x, y, z <= 2
@@ -441,9 +620,8 @@ namespace ilp_solver
 
         // Check that an invalid solution raises an exception.
         // This may not be implemented for all solvers, but it is for CBC and HiGHS.
-        // Normally the exception will be raised in set_start_solution.
-        // If the stub is used, it will be thrown after the solution is given to the solver in the external process
-        // which is invoked from maximize().
+        // Normally the exception will be raised in set_start_solution, also by the stub, which checks the solution itself.
+        // Solvers that check the solution only when solving throw it from maximize().
         const std::vector<double> invalid_solution{1., 1., 2.};
         BOOST_CHECK_THROW(p_solver->set_start_solution(invalid_solution); p_solver->maximize(), InvalidStartSolutionException);
 
@@ -498,6 +676,150 @@ namespace ilp_solver
     }
 
 
+    // A stop requested before a solve applies to that solve, but not to the next one.
+    void test_request_stop(ILPSolverInterface* p_solver)
+    {
+        // max x+y, 2x+3y <= 12.5, 0 <= x, y <= 10 integer
+        p_solver->add_variable_integer(1., 0., 10.);
+        p_solver->add_variable_integer(1., 0., 10.);
+        p_solver->add_constraint_upper(std::vector{2., 3.}, 12.5);
+
+        p_solver->request_stop();
+        p_solver->maximize();
+
+        p_solver->maximize();
+        BOOST_REQUIRE(p_solver->get_status() == SolutionStatus::PROVEN_OPTIMAL);
+        BOOST_REQUIRE_CLOSE(p_solver->get_objective(), 6., c_eps);
+    }
+
+
+    // A market split problem (Cornuejols and Dawande) with slacks, whose optimality takes hours to prove.
+    // The coefficients are even and the right-hand sides odd, such that no solution reaches the LP bound of 0.
+    // x = 0 with the slacks at the right-hand sides is feasible, and given as start solution, such that there is an incumbent.
+    constexpr auto c_market_split_rows  = 5;
+    constexpr auto c_market_split_items = 10*(c_market_split_rows - 1);
+
+    static std::vector<double> add_market_split(ILPSolverInterface* p_solver)
+    {
+        srand(3);
+        std::vector<std::vector<double>> rows(c_market_split_rows, std::vector<double>(c_market_split_items + 2*c_market_split_rows, 0.));
+        std::vector<double>              right_hand_sides;
+        for (auto i = 0; i < c_market_split_rows; ++i)
+        {
+            for (auto j = 0; j < c_market_split_items; ++j)
+                rows[i][j] = 2*(rand() % 50);
+            rows[i][c_market_split_items + 2*i]     =  1.;
+            rows[i][c_market_split_items + 2*i + 1] = -1.;
+            right_hand_sides.push_back(2*std::floor(0.25*std::accumulate(rows[i].begin(), rows[i].begin() + c_market_split_items, 0.)) + 1);
+        }
+
+        std::vector<double> start_solution(c_market_split_items, 0.);
+        for (auto j = 0; j < c_market_split_items; ++j)
+            p_solver->add_variable_boolean(0.);
+        for (const auto right_hand_side : right_hand_sides)
+        {
+            p_solver->add_variable_continuous(-1., 0., right_hand_side);
+            p_solver->add_variable_continuous(-1., 0., right_hand_side);
+            start_solution.push_back(right_hand_side);
+            start_solution.push_back(0.);
+        }
+        for (auto i = 0; i < c_market_split_rows; ++i)
+            p_solver->add_constraint_equality(rows[i], right_hand_sides[i]);
+        p_solver->set_start_solution(start_solution);
+        return start_solution;
+    }
+
+
+    // Maximizes the market split of add_market_split, and checks that the solve ended within p_max_seconds,
+    // long before the optimum, and kept a consistent incumbent.
+    static void require_market_split_ended_early(ILPSolverInterface* p_solver, const std::vector<double>& p_start_solution, double p_max_seconds)
+    {
+        const auto start_time = std::chrono::steady_clock::now();
+        p_solver->maximize();
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+        BOOST_REQUIRE_LT(seconds, p_max_seconds);
+        const auto status = p_solver->get_status();
+        BOOST_REQUIRE(status == SolutionStatus::SUBOPTIMAL || status == SolutionStatus::NO_SOLUTION);
+        if (status == SolutionStatus::SUBOPTIMAL)
+        {
+            const auto solution = p_solver->get_solution();
+            BOOST_REQUIRE_EQUAL(solution.size(), p_start_solution.size());
+            const auto slacks = std::accumulate(solution.begin() + c_market_split_items, solution.end(), 0.);
+            BOOST_REQUIRE_CLOSE(-slacks, p_solver->get_objective(), c_eps);
+            BOOST_REQUIRE_GE(p_solver->get_objective(), -std::accumulate(p_start_solution.begin(), p_start_solution.end(), 0.) - c_eps);
+        }
+    }
+
+
+    // A stop requested from another thread ends a running solve early, which keeps its incumbent.
+    void test_request_stop_running(ILPSolverInterface* p_solver)
+    {
+        constexpr auto c_max_seconds = 60.;   // Without the stop, the solve would take that long.
+        constexpr auto c_stop_delay  = std::chrono::seconds(1);
+        const auto start_solution = add_market_split(p_solver);
+        p_solver->set_max_seconds(c_max_seconds);
+
+        std::jthread stopper([p_solver, c_stop_delay]()
+        {
+            std::this_thread::sleep_for(c_stop_delay);
+            p_solver->request_stop();
+        });
+        require_market_split_ended_early(p_solver, start_solution, 0.25*c_max_seconds);
+    }
+
+
+    // max_seconds ends a running solve, which keeps its incumbent.
+    void test_max_seconds(ILPSolverInterface* p_solver)
+    {
+        const auto start_solution = add_market_split(p_solver);
+        p_solver->set_max_seconds(1.);
+        require_market_split_ended_early(p_solver, start_solution, 15.);
+    }
+
+
+    // max_seconds ends a running solve by stop_requested, even if the time limit of the solver itself is lifted by p_time_limit_name.
+    void test_max_seconds_by_stop_request(ILPSolverInterface* p_solver, const std::string& p_time_limit_name, const std::string& p_no_limit)
+    {
+        const auto start_solution = add_market_split(p_solver);
+        p_solver->set_max_seconds(1.);
+        p_solver->set_solver_parameter(p_time_limit_name, p_no_limit);
+        require_market_split_ended_early(p_solver, start_solution, 15.);
+    }
+
+
+    // The interim handler gets strictly improving solutions, the last one of which is the result.
+    void test_interim_results(ILPSolverInterface* p_solver)
+    {
+        // A knapsack with 20 items, such that the solvers usually find several solutions.
+        constexpr auto c_num_items = 20;
+        std::vector<double> weights;
+        for (auto j = 0; j < c_num_items; ++j)
+        {
+            weights.push_back(5. + (11*j) % 17);
+            p_solver->add_variable_boolean(10. + (7*j) % 13);
+        }
+        p_solver->add_constraint_upper(weights, 0.5*std::accumulate(weights.begin(), weights.end(), 0.));
+        p_solver->set_presolve(false);
+
+        // The stub and the portfolio call the handler from other threads, so it only records.
+        std::vector<double> objectives;
+        auto                all_complete = true;
+        p_solver->set_interim_results([&objectives, &all_complete](ILPSolutionData* p_data)
+        {
+            all_complete = all_complete && isize(p_data->solution) == c_num_items;
+            objectives.push_back(p_data->objective);
+        });
+        p_solver->maximize();
+
+        BOOST_REQUIRE(p_solver->get_status() == SolutionStatus::PROVEN_OPTIMAL);
+        BOOST_REQUIRE(all_complete);
+        BOOST_REQUIRE(!objectives.empty());
+        BOOST_REQUIRE(std::ranges::adjacent_find(objectives, std::greater_equal<>()) == objectives.end());
+        BOOST_REQUIRE_CLOSE(objectives.back(), p_solver->get_objective(), c_eps);
+    }
+
+
     void test_bad_alloc(ILPSolverInterface* p_solver)
     {
         srand(3);
@@ -545,15 +867,22 @@ namespace ilp_solver
 int create_ilp_test_suite()
 {
     using namespace ilp_solver;
-    constexpr std::array<std::pair<void (*)(ILPSolverInterface*), std::string_view>, 8> all_tests
-    { std::pair{test_sorting,                     "Sorting"}
-    , std::pair{test_linear_programming,          "LinProgr"}
-    , std::pair{test_start_solution_minimization, "StartSolutionMin"}
-    , std::pair{test_start_solution_maximization, "StartSolutionMax"}
-    , std::pair{test_cutoff,                      "CutOff"}
-    , std::pair{test_performance,                 "Performance"}
-    , std::pair{test_performance_big,             "PerformanceBig"}
-    , std::pair{test_performance_zero,            "PerformanceZero"}
+    constexpr std::array<std::pair<void (*)(ILPSolverInterface*), std::string_view>, 15> all_tests
+    { std::pair{&test_sorting,                      "Sorting"}
+    , std::pair{&test_linear_programming,           "LinProgr"}
+    , std::pair{&test_bulk_loading,                 "BulkLoading"}
+    , std::pair{&test_model_loading,                "ModelLoading"}
+    , std::pair{&test_model_loading_extend,         "ModelLoadingExtend"}
+    , std::pair{&test_start_solution_minimization,  "StartSolutionMin"}
+    , std::pair{&test_start_solution_maximization,  "StartSolutionMax"}
+    , std::pair{&test_cutoff,                       "CutOff"}
+    , std::pair{&test_request_stop,                 "RequestStop"}
+    , std::pair{&test_request_stop_running,         "RequestStopRunning"}
+    , std::pair{&test_max_seconds,                  "MaxSeconds"}
+    , std::pair{&test_interim_results,              "InterimResults"}
+    , std::pair{&test_performance,                  "Performance"}
+    , std::pair{&test_performance_big,              "PerformanceBig"}
+    , std::pair{&test_performance_zero,             "PerformanceZero"}
     };
 
     boost::unit_test::test_suite* IlpSolverT = BOOST_TEST_SUITE("IlpSolverT");
@@ -573,16 +902,76 @@ int create_ilp_test_suite()
         auto mps_lambda = [solver, solver_name]() { test_mps_output(solver().get(), std::string(solver_name) + "_unittest.mps"); };
         suite->add(boost::unit_test::make_test_case(mps_lambda, (std::string(solver_name) + "_MPSOut").c_str(), __FILE__, __LINE__));
 
+        // Lifting the time limit of SCIP by name shows that stop_requested alone ends the solve.
+        if (solver_name == "SCIP")
+        {
+            auto lambda = [solver]() { test_max_seconds_by_stop_request(solver().get(), "limits/time", "1e20"); };
+            suite->add(boost::unit_test::make_test_case(lambda, (std::string(solver_name) + "_MaxSecondsByStopRequest").c_str(), __FILE__, __LINE__));
+        }
+
         if (solver_name.rfind("Stub") != std::string::npos)
         {
             auto lambda = [solver]() { test_bad_alloc(solver().get()); };
             suite->add(boost::unit_test::make_test_case(lambda, (std::string(solver_name) + "_BadAlloc").c_str(), __FILE__, __LINE__));
+
+            // The stub writes the file by ILPSolverCollect. The files of the other solvers may differ, e.g., in the type of binary variables.
+            auto round_trip_lambda = [solver, solver_name]() { test_mps_round_trip(solver().get(), std::string(solver_name) + "_round_trip_unittest.mps"); };
+            suite->add(boost::unit_test::make_test_case(round_trip_lambda, (std::string(solver_name) + "_MPSRoundTrip").c_str(), __FILE__, __LINE__));
         }
 
         // Add the current solver to the IlpSolverT test suite.
         IlpSolverT->add(suite);
     }
 
+#ifdef WITH_STUB
+    // The pooled stub is not in all_solvers, because ScaiIlpExe takes its solver from there by position.
+    // Running all tests one after the other lets the workers solve many ILPs each.
+    boost::unit_test::test_suite* pooled_suite = BOOST_TEST_SUITE("StubPooled");
+    for (auto& [test, test_name] : all_tests)
+    {
+        auto lambda = [test]() { test(create_solver_stub_pooled("ScaiIlpExe.exe", false, 2).get()); };
+        pooled_suite->add(boost::unit_test::make_test_case(lambda, (std::string("StubPooled_") + test_name.data()).c_str(), __FILE__, __LINE__));
+    }
+    IlpSolverT->add(pooled_suite);
+
+    boost::unit_test::test_suite* prelaunched_suite = BOOST_TEST_SUITE("StubPrelaunched");
+    for (auto& [test, test_name] : all_tests)
+    {
+        auto lambda = [test]() { test(create_solver_stub_prelaunched("ScaiIlpExe.exe", false).get()); };
+        prelaunched_suite->add(boost::unit_test::make_test_case(lambda, (std::string("StubPrelaunched_") + test_name.data()).c_str(), __FILE__, __LINE__));
+    }
+    IlpSolverT->add(prelaunched_suite);
+
+    // The options of the stub combine: a prelaunched portfolio with a watchdog policy of its own.
+    boost::unit_test::test_suite* combined_suite = BOOST_TEST_SUITE("StubCombined");
+    for (auto& [test, test_name] : all_tests)
+    {
+        auto lambda = [test]()
+        {
+            const std::vector<PortfolioRacer> racers(2);
+            test(create_solver_stub(StubOptions{.prelaunch       = true,
+                                                .watchdog_policy = WatchdogPolicy{.stop_request_seconds = 0.5},
+                                                .racers          = racers.data(),
+                                                .num_racers      = isize(racers)}).get());
+        };
+        combined_suite->add(boost::unit_test::make_test_case(lambda, (std::string("StubCombined_") + test_name.data()).c_str(), __FILE__, __LINE__));
+    }
+    IlpSolverT->add(combined_suite);
+#endif
+
+    // The portfolio is not in all_solvers either, because it races the solvers from there in this process.
+    // Without any solver, e.g. in a Linux build without options, there is no portfolio.
+    if (create_solver_portfolio())
+    {
+        boost::unit_test::test_suite* portfolio_suite = BOOST_TEST_SUITE("Portfolio");
+        for (auto& [test, test_name] : all_tests)
+        {
+            auto lambda = [test]() { test(create_solver_portfolio().get()); };
+            portfolio_suite->add(boost::unit_test::make_test_case(lambda, (std::string("Portfolio_") + test_name.data()).c_str(), __FILE__, __LINE__));
+        }
+        IlpSolverT->add(portfolio_suite);
+    }
+
     // Add the whole IlpSolver test suite to the master test suite.
     boost::unit_test::framework::master_test_suite().add(IlpSolverT);
 
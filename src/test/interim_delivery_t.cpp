@@ -0,0 +1,184 @@
+#include "interim_delivery.hpp"
+
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+
+namespace ilp_solver
+{
+    constexpr auto c_num_variables = 3;
+
+    // Records the objectives of the solutions passed, and the addresses of their values.
+    struct Recorder
+    {
+        std::vector<double>        objectives;
+        std::vector<const double*> addresses;
+
+        void attach(InterimDelivery* v_delivery)
+        {
+            v_delivery->set_handler([this](ILPSolutionData* p_solution)
+            {
+                BOOST_REQUIRE_EQUAL(p_solution->solution.size(), static_cast<std::size_t>(c_num_variables));
+                BOOST_REQUIRE_EQUAL(p_solution->solution[0], p_solution->objective);
+                objectives.push_back(p_solution->objective);
+                addresses.push_back(p_solution->solution.data());
+            });
+        }
+    };
+
+
+    static void offer(InterimDelivery* v_delivery, double p_objective)
+    {
+        v_delivery->offer(p_objective, [p_objective](double* r_values)
+        {
+            std::fill_n(r_values, c_num_variables, p_objective);
+            return true;
+        });
+    }
+
+
+    void test_default_policy()
+    {
+        InterimDelivery delivery;
+        Recorder        recorder;
+        recorder.attach(&delivery);
+
+        delivery.start(InterimPolicy{}, ObjectiveSense::MAXIMIZE, c_num_variables);
+        for (auto objective : {1., 2., 2., 1.5, 3.})
+            offer(&delivery, objective);
+        delivery.finish();
+
+        BOOST_REQUIRE(recorder.objectives == (std::vector{1., 2., 3.}));
+        // No solution allocates.
+        BOOST_REQUIRE_EQUAL(recorder.addresses.front(), recorder.addresses.back());
+
+        // The next solve starts anew.
+        delivery.start(InterimPolicy{}, ObjectiveSense::MAXIMIZE, c_num_variables);
+        offer(&delivery, 1.);
+        BOOST_REQUIRE_EQUAL(recorder.objectives.back(), 1.);
+    }
+
+
+    void test_min_relative_improvement()
+    {
+        InterimDelivery delivery;
+        Recorder        recorder;
+        recorder.attach(&delivery);
+
+        InterimPolicy policy;
+        policy.min_relative_improvement = 0.1;
+        delivery.start(policy, ObjectiveSense::MINIMIZE, c_num_variables);
+        for (auto objective : {100., 95., 91., 89., 81.})
+            offer(&delivery, objective);
+        delivery.finish();
+
+        BOOST_REQUIRE(recorder.objectives == (std::vector{100., 89.}));
+    }
+
+
+    void test_coalesce()
+    {
+        InterimDelivery delivery;
+        Recorder        recorder;
+        recorder.attach(&delivery);
+
+        InterimPolicy policy;
+        policy.min_interval_seconds = 0.2;
+        delivery.start(policy, ObjectiveSense::MINIMIZE, c_num_variables);
+        offer(&delivery, 10.);
+        offer(&delivery, 9.);
+        offer(&delivery, 8.);
+        delivery.poll();
+        BOOST_REQUIRE(recorder.objectives == (std::vector{10.}));
+
+        // Only the latest solution is passed once the interval has passed.
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        delivery.poll();
+        delivery.poll();
+        BOOST_REQUIRE(recorder.objectives == (std::vector{10., 8.}));
+
+        // The last solution is passed at the end of the solve, even if the interval has not passed.
+        offer(&delivery, 7.);
+        BOOST_REQUIRE(recorder.objectives == (std::vector{10., 8.}));
+        delivery.finish();
+        BOOST_REQUIRE(recorder.objectives == (std::vector{10., 8., 7.}));
+    }
+
+
+    void test_no_coalesce()
+    {
+        InterimDelivery delivery;
+        Recorder        recorder;
+        recorder.attach(&delivery);
+
+        InterimPolicy policy;
+        policy.min_interval_seconds = 60.;
+        policy.coalesce             = false;
+        delivery.start(policy, ObjectiveSense::MINIMIZE, c_num_variables);
+        offer(&delivery, 10.);
+        offer(&delivery, 9.);
+        delivery.poll();
+        delivery.finish();
+
+        BOOST_REQUIRE(recorder.objectives == (std::vector{10.}));
+    }
+
+
+    // A solution whose values cannot be written is not passed, nor is the pending one it has overwritten.
+    void test_failed_fill()
+    {
+        InterimDelivery delivery;
+        Recorder        recorder;
+        recorder.attach(&delivery);
+
+        InterimPolicy policy;
+        policy.min_interval_seconds = 60.;
+        delivery.start(policy, ObjectiveSense::MINIMIZE, c_num_variables);
+        offer(&delivery, 10.);
+        offer(&delivery, 9.);
+        delivery.offer(8., [](double* r_values)
+        {
+            r_values[0] = -1.;
+            return false;
+        });
+        delivery.finish();
+        BOOST_REQUIRE(recorder.objectives == (std::vector{10.}));
+
+        // Later solutions are passed again.
+        offer(&delivery, 7.);
+        delivery.finish();
+        BOOST_REQUIRE(recorder.objectives == (std::vector{10., 7.}));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE( InterimDeliveryT );
+
+BOOST_AUTO_TEST_CASE ( DefaultPolicy )
+{
+    ilp_solver::test_default_policy();
+}
+
+BOOST_AUTO_TEST_CASE ( MinRelativeImprovement )
+{
+    ilp_solver::test_min_relative_improvement();
+}
+
+BOOST_AUTO_TEST_CASE ( Coalesce )
+{
+    ilp_solver::test_coalesce();
+}
+
+BOOST_AUTO_TEST_CASE ( NoCoalesce )
+{
+    ilp_solver::test_no_coalesce();
+}
+
+BOOST_AUTO_TEST_CASE ( FailedFill )
+{
+    ilp_solver::test_failed_fill();
+}
+
+BOOST_AUTO_TEST_SUITE_END();
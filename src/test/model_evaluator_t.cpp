@@ -0,0 +1,130 @@
+#include "ilp_data.hpp"
+#include "model_evaluator.hpp"
+#include "test_data.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+
+namespace ilp_solver
+{
+    void test_evaluate()
+    {
+        auto                 data = generate_small_mip();
+        const ModelEvaluator evaluator(make_view(data));
+        BOOST_REQUIRE_EQUAL(evaluator.num_variables(), 3);
+        BOOST_REQUIRE_EQUAL(evaluator.num_constraints(), 2);
+
+        std::vector<double> activities(2);
+        const auto          feasible = evaluator.evaluate(std::vector{5., 4., 1.}, activities);
+        BOOST_REQUIRE_EQUAL(feasible.objective, 15.);
+        BOOST_REQUIRE(feasible.is_feasible());
+        BOOST_REQUIRE(activities == (std::vector{10., 4.}));
+
+        // Each kind of violation. Only the one of the row is relative to its bound.
+        const auto out_of_bounds = evaluator.evaluate(std::vector{5., 9., 0.});
+        BOOST_REQUIRE_EQUAL(out_of_bounds.max_bound_violation, 1.);
+        BOOST_REQUIRE_EQUAL(out_of_bounds.max_row_violation, 4./10.);
+        BOOST_REQUIRE(!out_of_bounds.is_feasible());
+
+        const auto fractional = evaluator.evaluate(std::vector{4.25, 4., 0.});
+        BOOST_REQUIRE_EQUAL(fractional.max_integrality_violation, 0.25);
+        BOOST_REQUIRE_EQUAL(fractional.max_row_violation, 0.);
+        BOOST_REQUIRE(!fractional.is_feasible());
+        BOOST_REQUIRE(fractional.is_feasible(0.3));
+
+        // Of the first row by 1/7, of the second one by 1, whose bound is below 1.
+        const auto infeasible_row = evaluator.evaluate(std::vector{1., 4., 1.});
+        BOOST_REQUIRE_EQUAL(infeasible_row.max_row_violation, 1.);
+        BOOST_REQUIRE(!infeasible_row.is_feasible());
+
+        BOOST_REQUIRE(!evaluator.evaluate(std::vector{5., std::numeric_limits<double>::quiet_NaN(), 1.}).is_feasible());
+    }
+
+
+    // Rounding errors on a row with a large bound do not make a solution infeasible, but larger violations do.
+    void test_relative_violation()
+    {
+        auto data = generate_ilp_data(1, 1);
+        data.variable_upper   = {1e9};
+        data.constraint_upper = {1e8};
+        const ModelEvaluator evaluator(make_view(data));
+
+        BOOST_REQUIRE(evaluator.evaluate(std::vector{1e8 + 1.}).is_feasible());
+        BOOST_REQUIRE(!evaluator.evaluate(std::vector{1e8 + 1e3}).is_feasible());
+        BOOST_REQUIRE(!evaluator.evaluate(std::vector{-1e-3}).is_feasible());
+    }
+
+
+    // The bound of a variable is checked absolutely, also if it is large, unlike the same bound on a row.
+    void test_absolute_bound_violation()
+    {
+        auto data = generate_ilp_data(1, 1);
+        data.variable_upper   = {1e9};
+        data.constraint_upper = {1e10};
+        const ModelEvaluator evaluator(make_view(data));
+
+        const auto above_variable = evaluator.evaluate(std::vector{1e9 + 1.});
+        BOOST_REQUIRE_EQUAL(above_variable.max_bound_violation, 1.);
+        BOOST_REQUIRE_EQUAL(above_variable.max_row_violation, 0.);
+        BOOST_REQUIRE(!above_variable.is_feasible());
+
+        auto row_data = generate_ilp_data(1, 1);
+        row_data.variable_upper   = {1e10};
+        row_data.constraint_upper = {1e9};
+        const ModelEvaluator row_evaluator(make_view(row_data));
+        BOOST_REQUIRE(row_evaluator.evaluate(std::vector{1e9 + 1.}).is_feasible());
+    }
+
+
+    // The batch evaluates more candidates than fit in one block, and gives the same results as evaluating them one by one.
+    void test_evaluate_batch()
+    {
+        auto                 data = generate_small_mip();
+        const ModelEvaluator evaluator(make_view(data));
+
+        constexpr auto      num_candidates = 19;
+        std::vector<double> candidates;
+        for (auto c = 0; c < num_candidates; ++c)
+            candidates.insert(candidates.end(), {0.5*c, 0.25*c, static_cast<double>(c % 2)});
+
+        std::vector<SolutionEvaluation> evaluations(num_candidates);
+        evaluator.evaluate_batch(candidates, evaluations);
+        for (auto c = 0; c < num_candidates; ++c)
+        {
+            const auto expected = evaluator.evaluate(ValueArray(candidates).subspan(3*c, 3));
+            BOOST_REQUIRE_EQUAL(evaluations[c].objective, expected.objective);
+            BOOST_REQUIRE_EQUAL(evaluations[c].max_bound_violation, expected.max_bound_violation);
+            BOOST_REQUIRE_EQUAL(evaluations[c].max_integrality_violation, expected.max_integrality_violation);
+            BOOST_REQUIRE_EQUAL(evaluations[c].max_row_violation, expected.max_row_violation);
+        }
+        BOOST_REQUIRE(evaluations[10].is_feasible());  // (5, 2.5, 0)
+        BOOST_REQUIRE(!evaluations[11].is_feasible());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE( ModelEvaluatorT );
+
+BOOST_AUTO_TEST_CASE ( Evaluate )
+{
+    ilp_solver::test_evaluate();
+}
+
+BOOST_AUTO_TEST_CASE ( RelativeViolation )
+{
+    ilp_solver::test_relative_violation();
+}
+
+BOOST_AUTO_TEST_CASE ( AbsoluteBoundViolation )
+{
+    ilp_solver::test_absolute_bound_violation();
+}
+
+BOOST_AUTO_TEST_CASE ( EvaluateBatch )
+{
+    ilp_solver::test_evaluate_batch();
+}
+
+BOOST_AUTO_TEST_SUITE_END();
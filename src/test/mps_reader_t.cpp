@@ -0,0 +1,211 @@
+#include "ilp_solver_factory.hpp"
+#include "mps_reader.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+const auto c_eps = 0.0001;
+
+// Sizes of the generated files (about 250 bytes per column) for the throughput test, which runs always,
+// and for the benchmark, which is disabled and only runs if selected by --run_test=MpsReaderT/test_read_mps_benchmark.
+// Increase the latter to several million columns for benchmarks on multi-GB files.
+const auto c_throughput_num_columns = 20000;
+const auto c_benchmark_num_columns  = 200000;
+const auto c_benchmark_num_rows     = 1000;
+
+const bool LOGGING = true;
+
+// max  x + 2.5y
+// s.t. 7 <= x +  y + z <= 10
+//      1 <= x      - z <= 6
+//      2 <=      y     <= 4
+//      x integer in [0, 5], y <= 8, z binary
+// Optimum 15 at x = 5, y = 4.
+const auto c_test_model =
+    "* Test model, also containing features not written by ScaiIlp.\n"
+    "NAME          TESTMODEL\n"
+    "OBJSENSE\n"
+    "    MAX\n"
+    "ROWS\n"
+    " N  obj\n"
+    " L  c1\n"
+    " G  c2\n"
+    " E  c3\n"
+    " N  unused\n"
+    "COLUMNS\n"
+    "    MARKER                 'MARKER'                 'INTORG'\n"
+    "    x         obj          1   c1           1\n"
+    "    x         c2           +1\n"
+    "    MARKER                 'MARKER'                 'INTEND'\n"
+    "    y         obj          2.5 c1           1\n"
+    "    y         c3           1   unused       7\n"
+    "    z         c1           1\n"
+    "    z         c2           -1\n"
+    "RHS\n"
+    "    RHS       c1           10  c2           1\n"
+    "    RHS       obj          100\n"
+    "    c3        4\n"
+    "RANGES\n"
+    "    RNG       c1           3   c2           5\n"
+    "    RNG       c3           -2\n"
+    "BOUNDS\n"
+    " UP BND       x            5\n"
+    " MI BND       y\n"
+    " UP BND       y            8\n"
+    " BV BND       z\n"
+    "ENDATA\n";
+
+namespace ilp_solver
+{
+    static std::string write_file(const std::string& p_filename, const std::string& p_content)
+    {
+        boost::filesystem::ofstream outstream{boost::filesystem::path(p_filename)};
+        outstream << p_content;
+        return p_filename;
+    }
+
+
+    void test_read_mps()
+    {
+        const auto data = read_mps_file(write_file("mps_reader_unittest.mps", c_test_model));
+
+        BOOST_REQUIRE(data.objective_sense == ObjectiveSense::MAXIMIZE);
+        BOOST_REQUIRE(data.objective      == (std::pmr::vector<double>{1., 2.5, 0.}));
+        BOOST_REQUIRE(data.variable_lower == (std::pmr::vector<double>{0., c_neg_inf, 0.}));
+        BOOST_REQUIRE(data.variable_upper == (std::pmr::vector<double>{5., 8., 1.}));
+        BOOST_REQUIRE(data.variable_type  == (std::pmr::vector<VariableType>{VariableType::INTEGER, VariableType::CONTINUOUS, VariableType::BINARY}));
+
+        BOOST_REQUIRE(data.constraint_lower == (std::pmr::vector<double>{7., 1., 2.}));
+        BOOST_REQUIRE(data.constraint_upper == (std::pmr::vector<double>{10., 6., 4.}));
+
+        BOOST_REQUIRE(data.matrix.d_row_starts == (std::pmr::vector<int>{0, 3, 5, 6}));
+        BOOST_REQUIRE(data.matrix.d_indices    == (std::pmr::vector<int>{0, 1, 2, 0, 2, 1}));
+        BOOST_REQUIRE(data.matrix.d_values     == (std::pmr::vector<double>{1., 1., 1., 1., -1., 1.}));
+    }
+
+
+    void test_read_mps_errors()
+    {
+        BOOST_REQUIRE_THROW(read_mps_file("does_not_exist.mps"), std::runtime_error);
+
+        auto model = std::string(c_test_model);
+        model.replace(model.find(" UP BND       x"), 15, " UP BND       w");
+        BOOST_REQUIRE_THROW(read_mps_file(write_file("mps_reader_unittest.mps", model)), std::runtime_error);
+
+        model = std::string(c_test_model);
+        model.erase(model.find("ENDATA"));
+        BOOST_REQUIRE_THROW(read_mps_file(write_file("mps_reader_unittest.mps", model)), std::runtime_error);
+
+        // A column that appears again after another one is reported at its line, also without BOUNDS.
+        model = std::string(c_test_model);
+        model.replace(model.find("    z         c2"), 5, "    x");
+        model.erase(model.find("BOUNDS"), model.find("ENDATA") - model.find("BOUNDS"));
+        BOOST_REQUIRE_EXCEPTION(read_mps_file(write_file("mps_reader_unittest.mps", model)), std::runtime_error,
+                                [](const std::runtime_error& p_error)
+                                { return std::string(p_error.what()).find("(19): Column x") != std::string::npos; });
+    }
+
+
+    void test_load_mps(ILPSolverInterface* p_solver)
+    {
+        const auto sense = read_mps_file(write_file("mps_reader_unittest.mps", c_test_model), p_solver);
+
+        BOOST_REQUIRE_EQUAL(p_solver->get_num_variables(),   3);
+        BOOST_REQUIRE_EQUAL(p_solver->get_num_constraints(), 3);
+
+        if (sense == ObjectiveSense::MAXIMIZE)
+            p_solver->maximize();
+        else
+            p_solver->minimize();
+
+        BOOST_REQUIRE(p_solver->get_status() == SolutionStatus::PROVEN_OPTIMAL);
+        BOOST_REQUIRE_CLOSE(p_solver->get_objective(), 15., c_eps);
+        const auto solution = p_solver->get_solution();
+        BOOST_REQUIRE_CLOSE(solution[0], 5., c_eps);
+        BOOST_REQUIRE_CLOSE(solution[1], 4., c_eps);
+    }
+
+
+    // Generates a free MPS file with ten non-zeros per column and measures the time for reading it.
+    void test_read_mps_throughput(int p_num_columns)
+    {
+        const auto filename = std::string("mps_reader_benchmark.mps");
+        {
+            boost::filesystem::ofstream outstream{boost::filesystem::path(filename)};
+            outstream << "NAME BENCHMARK\nROWS\n N obj\n";
+            for (int i = 0; i < c_benchmark_num_rows; ++i)
+                outstream << " L R" << i << '\n';
+            outstream << "COLUMNS\n";
+            for (int j = 0; j < p_num_columns; ++j)
+            {
+                outstream << "    C" << j << " obj " << j % 7 + 1 << '\n';
+                for (int k = 0; k < 10; ++k)
+                    outstream << "    C" << j << " R" << (7 * j + 13 * k) % c_benchmark_num_rows << ' ' << 1.5 + k << '\n';
+            }
+            outstream << "RHS\n";
+            for (int i = 0; i < c_benchmark_num_rows; ++i)
+                outstream << "    RHS R" << i << " 100\n";
+            outstream << "BOUNDS\n";
+            for (int j = 0; j < p_num_columns; ++j)
+                outstream << " UP BND C" << j << " 4\n";
+            outstream << "ENDATA\n";
+        }
+
+        const auto start_time = std::chrono::steady_clock::now();
+        const auto data       = read_mps_file(filename);
+        const auto end_time   = std::chrono::steady_clock::now();
+
+        BOOST_REQUIRE_EQUAL(data.matrix.num_rows(),      c_benchmark_num_rows);
+        BOOST_REQUIRE_EQUAL(data.matrix.num_non_zeros(), 10 * p_num_columns);
+
+        if (LOGGING)
+        {
+            const auto size = boost::filesystem::file_size(filename);
+            const auto time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+            std::cout << "Reading an mps-File of " << size / 1000000 << " MB took " << time << " ms ("
+                      << (time > 0 ? size / 1000 / time : 0) << " MB/s)." << std::endl;
+        }
+        boost::filesystem::remove(filename);
+    }
+}
+
+
+int create_mps_reader_test_suite()
+{
+    using namespace ilp_solver;
+    boost::unit_test::test_suite* MpsReaderT = BOOST_TEST_SUITE("MpsReaderT");
+
+    MpsReaderT->add(BOOST_TEST_CASE(test_read_mps));
+    MpsReaderT->add(BOOST_TEST_CASE(test_read_mps_errors));
+    MpsReaderT->add(boost::unit_test::make_test_case([]() { test_read_mps_throughput(c_throughput_num_columns); },
+                                                     "test_read_mps_throughput", __FILE__, __LINE__));
+
+    auto* benchmark = boost::unit_test::make_test_case([]() { test_read_mps_throughput(c_benchmark_num_columns); },
+                                                       "test_read_mps_benchmark", __FILE__, __LINE__);
+    benchmark->p_default_status.value = boost::unit_test::test_unit::RS_DISABLED;
+    MpsReaderT->add(benchmark);
+
+    // Load the model into each kind of solver.
+    for (auto& [solver, solver_name] : all_solvers)
+    {
+        auto lambda = [solver]() { test_load_mps(solver().get()); };
+        MpsReaderT->add(boost::unit_test::make_test_case(lambda, (std::string(solver_name) + "_LoadMps").c_str(), __FILE__, __LINE__));
+    }
+
+    boost::unit_test::framework::master_test_suite().add(MpsReaderT);
+
+    return 0;
+}
+
+
+// Automatic registration of the test suite.
+namespace
+{
+    inline const int hidden_registrar{ create_mps_reader_test_suite() };
+}
@@ -0,0 +1,140 @@
+#include "portfolio_race.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+
+namespace ilp_solver
+{
+    static ILPSolutionData solution(SolutionStatus p_status, double p_objective)
+    {
+        ILPSolutionData solution(ObjectiveSense::MAXIMIZE);
+        solution.solution_status = p_status;
+        solution.objective       = p_objective;
+        solution.solution        = {p_objective};
+        return solution;
+    }
+
+
+    static std::exception_ptr failure()
+    {
+        return std::make_exception_ptr(std::runtime_error("Solver of portfolio racer not available."));
+    }
+
+
+    void test_winner()
+    {
+        const std::function<void(ILPSolutionData*)> no_handler;
+        PortfolioRace                               race(3, ObjectiveSense::MAXIMIZE, no_handler);
+        BOOST_REQUIRE(!race.is_decided());
+
+        race.finish(0, solution(SolutionStatus::SUBOPTIMAL, 5.));
+        BOOST_REQUIRE(!race.is_decided());
+        race.finish(1, solution(SolutionStatus::PROVEN_OPTIMAL, 4.));
+        BOOST_REQUIRE(race.is_decided());
+        race.finish(2, solution(SolutionStatus::PROVEN_OPTIMAL, 4.));
+
+        // The first proven racer wins, even if another one has a better solution, e.g. by a larger tolerance.
+        BOOST_REQUIRE_EQUAL(race.select_racer(), 1);
+        BOOST_REQUIRE_EQUAL(race.take_solution(1).objective, 4.);
+    }
+
+
+    void test_best_solution()
+    {
+        const std::function<void(ILPSolutionData*)> no_handler;
+        PortfolioRace                               race(3, ObjectiveSense::MAXIMIZE, no_handler);
+        race.finish(0, solution(SolutionStatus::NO_SOLUTION, 0.));
+        race.finish(1, solution(SolutionStatus::SUBOPTIMAL, 3.), true);   // E.g. killed after its time limit.
+        race.finish(2, solution(SolutionStatus::SUBOPTIMAL, 2.));
+        BOOST_REQUIRE(!race.is_decided());
+        BOOST_REQUIRE_EQUAL(race.select_racer(), 1);
+    }
+
+
+    // A failed racer does not stop the others, and its error counts only if no racer has a solution.
+    void test_failed_racer()
+    {
+        const std::function<void(ILPSolutionData*)> no_handler;
+        {
+            PortfolioRace race(2, ObjectiveSense::MAXIMIZE, no_handler);
+            race.fail(0, failure());
+            BOOST_REQUIRE(!race.is_decided());
+            race.finish(1, solution(SolutionStatus::SUBOPTIMAL, 1.));
+            BOOST_REQUIRE_EQUAL(race.select_racer(), 1);
+        }
+        {
+            PortfolioRace race(2, ObjectiveSense::MAXIMIZE, no_handler);
+            race.finish(0, solution(SolutionStatus::NO_SOLUTION, 0.));
+            race.fail(1, failure());
+            BOOST_REQUIRE_THROW(race.select_racer(), std::runtime_error);
+        }
+        {
+            // Failed by its exit code, such that the stub reports it.
+            PortfolioRace race(2, ObjectiveSense::MAXIMIZE, no_handler);
+            race.finish(0, solution(SolutionStatus::NO_SOLUTION, 0.));
+            race.finish(1, solution(SolutionStatus::NO_SOLUTION, 0.), true);
+            BOOST_REQUIRE_EQUAL(race.select_racer(), 1);
+        }
+    }
+
+
+    // Only improving solutions are passed on. If the handler throws, the race is decided, and the exception is rethrown.
+    void test_interim_results()
+    {
+        std::vector<double>                         objectives;
+        const std::function<void(ILPSolutionData*)> handler = [&objectives](ILPSolutionData* p_solution)
+        {
+            objectives.push_back(p_solution->objective);
+            if (p_solution->objective > 10.)
+                throw std::runtime_error("Interim handler failed.");
+        };
+        PortfolioRace race(2, ObjectiveSense::MAXIMIZE, handler);
+
+        for (const auto objective : {1., 3., 2., 3., 4.})
+        {
+            auto interim = solution(SolutionStatus::SUBOPTIMAL, objective);
+            race.offer_interim(&interim);
+        }
+        BOOST_REQUIRE(objectives == std::vector<double>({1., 3., 4.}));
+        BOOST_REQUIRE(!race.is_decided());
+
+        auto failing = solution(SolutionStatus::SUBOPTIMAL, 11.);
+        race.offer_interim(&failing);
+        BOOST_REQUIRE(race.is_decided());
+        auto later = solution(SolutionStatus::SUBOPTIMAL, 12.);
+        race.offer_interim(&later);
+        BOOST_REQUIRE_EQUAL(objectives.size(), 4u);
+
+        race.finish(0, solution(SolutionStatus::PROVEN_OPTIMAL, 12.));
+        race.finish(1, solution(SolutionStatus::SUBOPTIMAL, 12.));
+        BOOST_REQUIRE_THROW(race.select_racer(), std::runtime_error);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE( PortfolioRaceT );
+
+BOOST_AUTO_TEST_CASE ( Winner )
+{
+    ilp_solver::test_winner();
+}
+
+BOOST_AUTO_TEST_CASE ( BestSolution )
+{
+    ilp_solver::test_best_solution();
+}
+
+BOOST_AUTO_TEST_CASE ( FailedRacer )
+{
+    ilp_solver::test_failed_racer();
+}
+
+BOOST_AUTO_TEST_CASE ( InterimResults )
+{
+    ilp_solver::test_interim_results();
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -1,12 +1,19 @@
 #include "serialization.hpp"
 
 #include <boost/test/unit_test.hpp>
+#include <chrono>
 #include <iostream>
 #include <vector>
 
 
 const auto c_max_vector_size = 10;
 
+// Sizes of the vectors reserved for a result in the size computation benchmark.
+const auto c_benchmark_num_variables   = 5000000;
+const auto c_benchmark_num_constraints = 1000000;
+
+const bool LOGGING = true;
+
 struct Data
 {
     enum class Enumeration { ENUM1, ENUM2, ENUM3 };
@@ -157,7 +164,7 @@ static Result generate_random_result()
 }
 
 
-static void* serialize(const Data& p_data, std::vector<char>* r_memory)
+static void* serialize(const Data& p_data, std::vector<char>* r_memory, SerializationLayout p_layout)
 {
     Result result;
 
@@ -181,7 +188,7 @@ static void* serialize(const Data& p_data, std::vector<char>* r_memory)
     {
         // i == 0: simulation to determine required amount of bytes
         // i == 1: write to memory
-        Serializer serializer(i == 0 ? nullptr : r_memory->data());
+        Serializer serializer(i == 0 ? nullptr : r_memory->data(), p_layout);
 
         serializer << p_data.vector_2_double
                    << p_data.value_bool
@@ -218,11 +225,11 @@ static void* serialize(const Data& p_data, std::vector<char>* r_memory)
 }
 
 
-static Data deserialize(void* p_address, void** v_result_address)
+static Data deserialize(void* p_address, void** v_result_address, SerializationLayout p_layout)
 {
     Data data;
 
-    Deserializer deserializer(p_address);
+    Deserializer deserializer(p_address, p_layout);
 
     deserializer >> data.vector_2_double
                  >> data.value_bool
@@ -240,9 +247,9 @@ static Data deserialize(void* p_address, void** v_result_address)
 }
 
 
-static void serialize_result(const Result& p_result, void* p_result_address)
+static void serialize_result(const Result& p_result, void* p_result_address, SerializationLayout p_layout)
 {
-    Serializer serializer(p_result_address);
+    Serializer serializer(p_result_address, p_layout);
     serializer << p_result.vector_3_char
                << p_result.vector_1_int
                << p_result.vector_2_double
@@ -251,11 +258,11 @@ static void serialize_result(const Result& p_result, void* p_result_address)
 };
 
 
-static Result deserialize_result(void* p_result_address)
+static Result deserialize_result(void* p_result_address, SerializationLayout p_layout)
 {
     Result result;
 
-    Deserializer deserializer(p_result_address);
+    Deserializer deserializer(p_result_address, p_layout);
     deserializer >> result.vector_3_char
                  >> result.vector_1_int
                  >> result.vector_2_double
@@ -266,9 +273,9 @@ static Result deserialize_result(void* p_result_address)
 }
 
 
-static void verify_zero(void* p_result_address)
+static void verify_zero(void* p_result_address, SerializationLayout p_layout)
 {
-    auto result = deserialize_result(p_result_address);
+    auto result = deserialize_result(p_result_address, p_layout);
 
     BOOST_REQUIRE_EQUAL(result.value_int              , 0);
     BOOST_REQUIRE      (result.value_enum           ==  Result::Enumeration::ENUM_NO_RESULT);
@@ -309,37 +316,145 @@ static void verify_equality(const Result& p_result_1, const Result& p_result_2)
 }
 
 
-void test_serialization()
+void test_serialization(SerializationLayout p_layout)
 {
     // Alice: Generate data and serialize it
     const auto data_alice = generate_random_data();
 
     std::vector<char> memory;
-    const auto result_address_alice = serialize(data_alice, &memory);
+    const auto result_address_alice = serialize(data_alice, &memory, p_layout);
 
-    verify_zero(result_address_alice);   // result is zero unless Bob serialized his result
+    verify_zero(result_address_alice, p_layout);   // result is zero unless Bob serialized his result
 
     // Bob: Deserialize data and serialize result in the same memory
     void* result_address_bob;
-    auto data_bob = deserialize(memory.data(), &result_address_bob);
+    auto data_bob = deserialize(memory.data(), &result_address_bob, p_layout);
 
     verify_equality(data_alice, data_bob);
     verify_equality(result_address_alice, result_address_bob);
 
     const auto result_bob = generate_random_result();
-    serialize_result(result_bob, result_address_bob);
+    serialize_result(result_bob, result_address_bob, p_layout);
 
     // Alice: Deserialize result
-    const auto result_alice = deserialize_result(result_address_alice);
+    const auto result_alice = deserialize_result(result_address_alice, p_layout);
 
     verify_equality(result_alice, result_bob);
 }
 
+
+static std::size_t required_bytes(const Data& p_data, SerializationLayout p_layout)
+{
+    Serializer serializer(nullptr, p_layout);
+    serializer << SerializationHeader::create(0)
+               << p_data.vector_2_double
+               << p_data.value_bool
+               << p_data.value_char
+               << p_data.vector_1_int;
+    return serializer.required_bytes();
+}
+
+
+void test_compact_header()
+{
+    const auto data      = generate_random_data();
+    const auto num_bytes = required_bytes(data, SerializationLayout::COMPACT);
+
+    // The compact layout never needs more memory than the padded one.
+    BOOST_REQUIRE_LE(num_bytes, required_bytes(data, SerializationLayout::PADDED));
+
+    std::vector<char> memory(num_bytes);
+    Serializer serializer(memory.data(), SerializationLayout::COMPACT);
+    serializer << SerializationHeader::create(num_bytes)
+               << data.vector_2_double
+               << data.value_bool
+               << data.value_char
+               << data.vector_1_int;
+    BOOST_REQUIRE_EQUAL(serializer.required_bytes(), num_bytes);
+
+    SerializationHeader header{};
+    Data data_read;
+    Deserializer deserializer(memory.data(), SerializationLayout::COMPACT);
+    deserializer >> header
+                 >> data_read.vector_2_double
+                 >> data_read.value_bool
+                 >> data_read.value_char
+                 >> data_read.vector_1_int;
+
+    BOOST_REQUIRE(header.is_valid());
+    BOOST_REQUIRE_EQUAL(header.total_size, num_bytes);
+    BOOST_REQUIRE_EQUAL(data_read.value_bool, data.value_bool);
+    BOOST_REQUIRE_EQUAL(data_read.value_char, data.value_char);
+    BOOST_REQUIRE      (data_read.vector_1_int    == data.vector_1_int);
+    BOOST_REQUIRE      (data_read.vector_2_double == data.vector_2_double);
+}
+
+// Compares the computed size to the simulated serialization, which needs the result vectors to exist.
+void test_required_size(SerializationLayout p_layout)
+{
+    const auto data = generate_random_data();
+
+    const auto start_time = std::chrono::steady_clock::now();
+
+    Result result;
+    result.vector_1_int.resize(c_benchmark_num_variables);
+    result.vector_2_double.resize(1, std::vector<double>(c_benchmark_num_constraints));
+
+    Serializer serializer(nullptr, p_layout);
+    serializer << data.value_char
+               << data.vector_1_int
+               << data.value_double
+               << result.vector_1_int
+               << result.value_enum
+               << result.vector_2_double;
+    const auto simulated_bytes = serializer.required_bytes();
+
+    const auto middle_time = std::chrono::steady_clock::now();
+
+    SerializedSize size(p_layout);
+    size.add(data.value_char)
+        .add(data.vector_1_int)
+        .add(data.value_double)
+        .add_vector<int>(c_benchmark_num_variables)
+        .add_value<Result::Enumeration>()
+        .add_value<int>()
+        .add_vector<double>(c_benchmark_num_constraints);
+    const auto computed_bytes = size.required_bytes();
+
+    const auto end_time = std::chrono::steady_clock::now();
+
+    BOOST_REQUIRE_EQUAL(computed_bytes, simulated_bytes);
+
+    if (LOGGING)
+    {
+        const auto time_simulated = std::chrono::duration_cast<std::chrono::microseconds>(middle_time - start_time).count();
+        const auto time_computed  = std::chrono::duration_cast<std::chrono::microseconds>(  end_time - middle_time).count();
+        std::cout << "Determining " << computed_bytes / 1000000 << " MB to reserve took " << time_simulated
+                  << " us by simulated serialization and " << time_computed << " us by computation." << std::endl;
+    }
+}
+
 BOOST_AUTO_TEST_SUITE( IlpSolverSerializationT );
 
 BOOST_AUTO_TEST_CASE ( SerializationAndDeserialization )
 {
-    test_serialization ();
+    test_serialization (SerializationLayout::PADDED);
+}
+
+BOOST_AUTO_TEST_CASE ( CompactSerializationAndDeserialization )
+{
+    test_serialization (SerializationLayout::COMPACT);
+}
+
+BOOST_AUTO_TEST_CASE ( CompactHeader )
+{
+    test_compact_header ();
+}
+
+BOOST_AUTO_TEST_CASE ( RequiredSize )
+{
+    test_required_size (SerializationLayout::PADDED);
+    test_required_size (SerializationLayout::COMPACT);
 }
 
 BOOST_AUTO_TEST_SUITE_END();
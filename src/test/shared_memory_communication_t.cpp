@@ -0,0 +1,239 @@
+#include "ilp_data.hpp"
+#include "shared_memory_communication.hpp"
+#include "test_data.hpp"
+
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+const auto c_num_variables   = 10000;
+const auto c_num_constraints = 100;
+const auto c_num_solutions   = 16;     // Prepared, such that the writer is fast enough to overtake the reader.
+const auto c_num_reads       = 2000;
+
+namespace ilp_solver
+{
+    // All values of the p_index-th solution equal p_index, so mixing two solutions is detected.
+    static ILPSolutionData generate_solution(int p_index, int p_num_variables, int p_num_constraints)
+    {
+        ILPSolutionData solution;
+        solution.solution.assign(p_num_variables, p_index);
+        solution.dual_sol.assign(p_num_constraints, p_index);
+        solution.objective       = p_index;
+        solution.solution_status = SolutionStatus::SUBOPTIMAL;
+        solution.cpu_time_sec    = p_index;
+        solution.peak_memory     = p_index;
+        return solution;
+    }
+
+
+    static void check_solution(const ILPSolutionData& p_solution, int p_num_variables, int p_num_constraints)
+    {
+        const auto index = p_solution.objective;
+        BOOST_REQUIRE_EQUAL(p_solution.solution.size(), static_cast<std::size_t>(p_num_variables));
+        BOOST_REQUIRE_EQUAL(p_solution.dual_sol.size(), static_cast<std::size_t>(p_num_constraints));
+        BOOST_REQUIRE(std::ranges::all_of(p_solution.solution, [index](double p_value) { return p_value == index; }));
+        BOOST_REQUIRE(std::ranges::all_of(p_solution.dual_sol, [index](double p_value) { return p_value == index; }));
+        BOOST_REQUIRE_EQUAL(p_solution.cpu_time_sec, index);
+        BOOST_REQUIRE_EQUAL(p_solution.peak_memory, index);
+    }
+
+
+    void test_read_last_committed_solution()
+    {
+        CommunicationPair communicators(generate_ilp_data(c_num_variables, c_num_constraints));
+        auto&             parent = communicators.parent;
+        auto&             child  = communicators.child;
+
+        ILPSolutionData initial;
+        parent.read_solution_data(&initial);
+        BOOST_REQUIRE(initial.solution_status == SolutionStatus::NO_SOLUTION);
+        BOOST_REQUIRE_EQUAL(initial.objective, std::numeric_limits<double>::max());
+
+        for (auto i = 1; i <= 3; ++i)
+        {
+            child.write_solution_data(generate_solution(i, c_num_variables, c_num_constraints));
+
+            ILPSolutionData solution;
+            parent.read_solution_data(&solution);
+            BOOST_REQUIRE_EQUAL(solution.objective, i);
+            check_solution(solution, c_num_variables, c_num_constraints);
+        }
+
+        // A solution larger than reserved is rejected and leaves the last one intact.
+        BOOST_REQUIRE_THROW(child.write_solution_data(generate_solution(4, 2*c_num_variables, c_num_constraints)),
+                            std::runtime_error);
+        ILPSolutionData solution;
+        parent.read_solution_data(&solution);
+        BOOST_REQUIRE_EQUAL(solution.objective, 3);
+    }
+
+
+    void test_wait_for_solution()
+    {
+        CommunicationPair communicators(generate_ilp_data(c_num_variables, c_num_constraints));
+        auto&             parent = communicators.parent;
+        auto&             child  = communicators.child;
+
+        BOOST_REQUIRE(!parent.wait_for_solution_data(std::chrono::milliseconds(10)));
+
+        // Wakes up on the solution written by the other thread, long before the maximum wait time.
+        std::jthread writer([&child]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            child.write_solution_data(generate_solution(1, c_num_variables, c_num_constraints));
+        });
+        const auto start_time = std::chrono::steady_clock::now();
+        BOOST_REQUIRE(parent.wait_for_solution_data(std::chrono::minutes(1)));
+        BOOST_REQUIRE_LT(std::chrono::steady_clock::now() - start_time, std::chrono::seconds(10));
+        writer.join();
+
+        // Stays signalled until the solution is read, even if it is peeked at.
+        ILPSolutionData solution;
+        parent.peek_solution_data(&solution);
+        BOOST_REQUIRE_EQUAL(solution.objective, 1);
+        BOOST_REQUIRE(parent.wait_for_solution_data(std::chrono::milliseconds(0)));
+        parent.read_solution_data(&solution);
+        BOOST_REQUIRE_EQUAL(solution.objective, 1);
+        BOOST_REQUIRE(!parent.wait_for_solution_data(std::chrono::milliseconds(10)));
+    }
+
+
+    void test_request_stop()
+    {
+        CommunicationPair communicators(generate_ilp_data(c_num_variables, c_num_constraints));
+        auto&             parent = communicators.parent;
+        auto&             child  = communicators.child;
+
+        BOOST_REQUIRE(!child.stop_requested());
+        parent.request_stop();
+        BOOST_REQUIRE(child.stop_requested());
+
+        // The child can still deliver its last solution after the request.
+        child.write_solution_data(generate_solution(1, c_num_variables, c_num_constraints));
+        ILPSolutionData solution;
+        parent.read_solution_data(&solution);
+        BOOST_REQUIRE_EQUAL(solution.objective, 1);
+    }
+
+
+    void test_solver_selection()
+    {
+        auto data    = generate_ilp_data(c_num_variables, c_num_constraints);
+        data.backend = SolverBackend::HIGHS;
+        data.add_solver_parameter("mip_heuristic_effort", "0.3");
+        data.add_solver_parameter("presolve", "");
+        CommunicationParent parent;
+        CommunicationChild  child(parent.write_ilp_data(data));
+        const auto          view = child.read_ilp_data();
+
+        BOOST_REQUIRE(view.backend == SolverBackend::HIGHS);
+        std::vector<std::pair<std::string, std::string>> parameters;
+        for_each_solver_parameter(view.solver_parameters, [&parameters](const std::string& p_name, const std::string& p_value)
+                                  { parameters.emplace_back(p_name, p_value); });
+        BOOST_REQUIRE_EQUAL(parameters.size(), 2u);
+        BOOST_REQUIRE_EQUAL(parameters[0].first, "mip_heuristic_effort");
+        BOOST_REQUIRE_EQUAL(parameters[0].second, "0.3");
+        BOOST_REQUIRE_EQUAL(parameters[1].first, "presolve");
+        BOOST_REQUIRE_EQUAL(parameters[1].second, "");
+    }
+
+
+    // Once the child has read the data, the parent may remove the name, and both still communicate through the memory.
+    void test_remove_name_once_read()
+    {
+        CommunicationParent parent;
+        const auto          name = parent.write_ilp_data(generate_ilp_data(c_num_variables, c_num_constraints));
+
+        parent.remove_name_once_read();
+        CommunicationChild child(name);
+        child.read_ilp_data();
+        parent.remove_name_once_read();
+#ifndef _WIN32
+        BOOST_REQUIRE_THROW(CommunicationChild{name}, std::exception);
+#endif
+
+        child.write_solution_data(generate_solution(1, c_num_variables, c_num_constraints));
+        ILPSolutionData solution;
+        parent.read_solution_data(&solution);
+        check_solution(solution, c_num_variables, c_num_constraints);
+    }
+
+
+    // The parent reads while the child writes. Each read sees the shared memory as a kill at that moment would leave it,
+    // so each read must return a complete solution.
+    void test_concurrent_reads()
+    {
+        CommunicationPair communicators(generate_ilp_data(c_num_variables, c_num_constraints));
+        auto&             parent = communicators.parent;
+        auto&             child  = communicators.child;
+
+        std::vector<ILPSolutionData> solutions;
+        for (auto i = 1; i <= c_num_solutions; ++i)
+            solutions.push_back(generate_solution(i, c_num_variables, c_num_constraints));
+        child.write_solution_data(solutions.back());
+
+        // Stopped and joined on destruction, also if a check below fails.
+        auto         num_writes = 0;
+        std::jthread writer([&](std::stop_token p_stop)
+        {
+            for (; !p_stop.stop_requested(); ++num_writes)
+                child.write_solution_data(solutions[num_writes % c_num_solutions]);
+        });
+
+        for (auto i = 0; i < c_num_reads; ++i)
+        {
+            ILPSolutionData solution;
+            parent.read_solution_data(&solution);
+            check_solution(solution, c_num_variables, c_num_constraints);
+        }
+        writer.request_stop();
+        writer.join();
+
+        ILPSolutionData solution;
+        parent.read_solution_data(&solution);
+        BOOST_REQUIRE_EQUAL(solution.objective, solutions[(num_writes - 1) % c_num_solutions].objective);
+        BOOST_TEST_MESSAGE(num_writes << " writes during " << c_num_reads << " reads.");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE( SharedMemoryCommunicationT );
+
+BOOST_AUTO_TEST_CASE ( ReadLastCommittedSolution )
+{
+    ilp_solver::test_read_last_committed_solution();
+}
+
+BOOST_AUTO_TEST_CASE ( WaitForSolution )
+{
+    ilp_solver::test_wait_for_solution();
+}
+
+BOOST_AUTO_TEST_CASE ( RequestStop )
+{
+    ilp_solver::test_request_stop();
+}
+
+BOOST_AUTO_TEST_CASE ( ConcurrentReads )
+{
+    ilp_solver::test_concurrent_reads();
+}
+
+BOOST_AUTO_TEST_CASE ( RemoveNameOnceRead )
+{
+    ilp_solver::test_remove_name_once_read();
+}
+
+BOOST_AUTO_TEST_CASE ( SolverSelection )
+{
+    ilp_solver::test_solver_selection();
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ilp_data.hpp"
+#include "shared_memory_communication.hpp"
+
+#include <vector>
+
+namespace ilp_solver
+{
+    // p_num_variables continuous variables in [0, 1] with objective 1,
+    // and p_num_constraints constraints 0 <= x_1 + ... + x_n <= 1.
+    inline ILPData generate_ilp_data(int p_num_variables, int p_num_constraints)
+    {
+        ILPData data;
+        data.objective.assign(p_num_variables, 1.);
+        data.variable_lower.assign(p_num_variables, 0.);
+        data.variable_upper.assign(p_num_variables, 1.);
+        data.variable_type.assign(p_num_variables, VariableType::CONTINUOUS);
+
+        const std::vector<double> row(p_num_variables, 1.);
+        for (auto i = 0; i < p_num_constraints; ++i)
+            data.matrix.append_row(row);
+        data.constraint_lower.assign(p_num_constraints, 0.);
+        data.constraint_upper.assign(p_num_constraints, 1.);
+        return data;
+    }
+
+
+    // max  x + 2.5y
+    // s.t. 7 <= x + y + z <= 10
+    //      1 <= x     - z
+    //      x integer in [0, 5], y in [0, 8], z binary
+    // Optimum 15 at x = 5, y = 4, z = 1.
+    inline ILPData generate_small_mip()
+    {
+        ILPData data;
+        data.objective        = {1., 2.5, 0.};
+        data.variable_lower   = {0., 0., 0.};
+        data.variable_upper   = {5., 8., 1.};
+        data.variable_type    = {VariableType::INTEGER, VariableType::CONTINUOUS, VariableType::BINARY};
+        data.constraint_lower = {7., 1.};
+        data.constraint_upper = {10., c_pos_inf};
+        data.matrix.append_row(std::vector{1., 1., 1.});
+        data.matrix.append_row(std::vector{1., 0., -1.});
+        return data;
+    }
+
+
+    // The stub and ScaiIlpExe after the stub has written p_data and ScaiIlpExe has read it.
+    struct CommunicationPair
+    {
+        explicit CommunicationPair(const ILPData& p_data) : child(parent.write_ilp_data(p_data))
+        {
+            child.read_ilp_data();
+        }
+
+        CommunicationParent parent;
+        CommunicationChild  child;
+    };
+}
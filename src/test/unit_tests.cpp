@@ -14,5 +14,10 @@ int main(int p_argc, char* p_argv[])
 {
     // Make boost::filesystem treat all char-based strings as UTF-8.
     boost::nowide::nowide_filesystem();
+    // Die dynamisch gelinkte Boost.Test (Linux-Build) erwartet init_unit_test.
+#ifdef BOOST_TEST_DYN_LINK
+    return boost::unit_test::unit_test_main(init_unit_test, p_argc, p_argv);
+#else
     return unit_test_main(init_unit_test_suite, p_argc, p_argv);
+#endif
 }
@@ -0,0 +1,176 @@
+#ifdef WITH_STUB
+
+#include "ilp_data.hpp"
+#include "shared_memory_communication.hpp"
+#include "test_data.hpp"
+#include "watchdog.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <string>
+#include <thread>
+
+
+// Short times, such that the tests run fast, but long enough compared to c_watchdog_check_interval.
+const auto c_timeout_seconds = 0.3;
+const auto c_max_test_time   = std::chrono::seconds(10);
+const auto c_num_variables   = 3;
+
+namespace ilp_solver
+{
+    static WatchdogPolicy short_policy()
+    {
+        WatchdogPolicy policy;
+        policy.stop_request_seconds      = 0.;
+        policy.idle_timeout_seconds      = c_timeout_seconds;
+        policy.stall_timeout_seconds     = c_timeout_seconds;
+        policy.absolute_overtime_seconds = 60.;
+        return policy;
+    }
+
+
+    // Checks like the stub does until the watchdog says to kill. Returns the seconds until then.
+    static double seconds_until_kill(Watchdog* v_watchdog)
+    {
+        const auto start_time = std::chrono::steady_clock::now();
+        while (!v_watchdog->check())
+        {
+            BOOST_REQUIRE_LT(std::chrono::steady_clock::now() - start_time, c_max_test_time);
+            std::this_thread::sleep_for(c_watchdog_check_interval);
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    }
+
+
+    void test_stop_request()
+    {
+        CommunicationPair communicators(generate_ilp_data(c_num_variables, 0));
+        auto&             parent = communicators.parent;
+        auto&             child  = communicators.child;
+
+        // Before the time limit, only the stop condition of the stub leads to the stop request.
+        auto     stop = false;
+        Watchdog watchdog(short_policy(), 60., &parent, [&stop](const SolverProgress*) { return stop; });
+        BOOST_REQUIRE(!watchdog.check());
+        BOOST_REQUIRE(!child.stop_requested());
+        stop = true;
+        BOOST_REQUIRE(!watchdog.check());
+        BOOST_REQUIRE(child.stop_requested());
+
+        // After the time limit, the stop is requested anyway.
+        CommunicationPair communicators_2(generate_ilp_data(c_num_variables, 0));
+        auto&             parent_2 = communicators_2.parent;
+        auto&             child_2  = communicators_2.child;
+        Watchdog watchdog_2(short_policy(), 0., &parent_2);
+        BOOST_REQUIRE(!watchdog_2.check());
+        BOOST_REQUIRE(child_2.stop_requested());
+    }
+
+
+    // The time a job waits for a worker does not count, but the stop condition applies while it waits.
+    void test_start_after_waiting()
+    {
+        CommunicationPair communicators(generate_ilp_data(c_num_variables, 0));
+        auto&             parent = communicators.parent;
+        auto&             child  = communicators.child;
+
+        auto     stop = false;
+        Watchdog watchdog(short_policy(), c_timeout_seconds, &parent, [&stop](const SolverProgress*) { return stop; });
+        std::this_thread::sleep_for(std::chrono::duration<double>(3*c_timeout_seconds));
+        BOOST_REQUIRE(!watchdog.stop_requested_before_start());
+
+        watchdog.start();
+        BOOST_REQUIRE(!watchdog.check());
+        BOOST_REQUIRE(!child.stop_requested());
+
+        stop = true;
+        BOOST_REQUIRE(watchdog.stop_requested_before_start());
+        BOOST_REQUIRE(child.stop_requested());
+    }
+
+
+    void test_kill_without_heartbeat()
+    {
+        CommunicationPair communicators(generate_ilp_data(c_num_variables, 0));
+        auto&             parent = communicators.parent;
+
+        Watchdog watchdog(short_policy(), 0., &parent);
+        BOOST_REQUIRE_GE(seconds_until_kill(&watchdog), c_timeout_seconds);
+        BOOST_REQUIRE_EQUAL(watchdog.kill_reason().find("no heartbeat"), 0u);
+    }
+
+
+    // A child that beats, but makes no progress, is killed later than one that does not beat.
+    void test_kill_without_progress()
+    {
+        CommunicationPair communicators(generate_ilp_data(c_num_variables, 0));
+        auto&             parent = communicators.parent;
+        auto&             child  = communicators.child;
+
+        auto policy = short_policy();
+        policy.stall_timeout_seconds = 2*c_timeout_seconds;
+        Watchdog     watchdog(policy, 0., &parent);
+        std::jthread beating([&child](std::stop_token p_stop)
+        {
+            while (!p_stop.stop_requested())
+            {
+                child.write_heartbeat();
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        });
+        BOOST_REQUIRE_GE(seconds_until_kill(&watchdog), policy.stall_timeout_seconds);
+        BOOST_REQUIRE_EQUAL(watchdog.kill_reason().find("no progress"), 0u);
+    }
+
+
+    // Long gaps between heartbeats before the time limit extend the idle timeout after it.
+    void test_adaptive_idle_timeout()
+    {
+        CommunicationPair communicators(generate_ilp_data(c_num_variables, 0));
+        auto&             parent = communicators.parent;
+        auto&             child  = communicators.child;
+
+        auto policy = short_policy();
+        policy.stall_timeout_seconds = 60.;
+        policy.gap_factor            = 2.;
+        const auto gap_seconds       = 2*c_timeout_seconds;
+        Watchdog   watchdog(policy, gap_seconds, &parent);
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(gap_seconds) - c_watchdog_check_interval);
+        child.write_heartbeat();
+        BOOST_REQUIRE(!watchdog.check());
+        BOOST_REQUIRE_GE(seconds_until_kill(&watchdog), policy.gap_factor*gap_seconds - 0.1);
+        BOOST_REQUIRE_EQUAL(watchdog.kill_reason().find("no heartbeat"), 0u);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE( WatchdogT );
+
+BOOST_AUTO_TEST_CASE ( StopRequest )
+{
+    ilp_solver::test_stop_request();
+}
+
+BOOST_AUTO_TEST_CASE ( StartAfterWaiting )
+{
+    ilp_solver::test_start_after_waiting();
+}
+
+BOOST_AUTO_TEST_CASE ( KillWithoutHeartbeat )
+{
+    ilp_solver::test_kill_without_heartbeat();
+}
+
+BOOST_AUTO_TEST_CASE ( KillWithoutProgress )
+{
+    ilp_solver::test_kill_without_progress();
+}
+
+BOOST_AUTO_TEST_CASE ( AdaptiveIdleTimeout )
+{
+    ilp_solver::test_adaptive_idle_timeout();
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+#endif